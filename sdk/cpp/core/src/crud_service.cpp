@@ -27,22 +27,37 @@
 #include "types.hpp"
 #include "path_api.hpp"
 #include "entity_data_node_walker.hpp"
+#include "errors.hpp"
 
 using namespace std;
 
 namespace ydk {
 static string get_data_payload(Entity & entity, path::RootSchemaNode & root_schema);
+static void set_rpc_data(path::ServiceProvider & provider, path::Rpc & rpc, const vector<Entity*> & entities,
+		const string & data_tag);
 static path::DataNode* execute_rpc(path::ServiceProvider & provider, Entity & entity,
 		const string & operation, const string & data_tag, bool set_config_flag=false);
 static path::DataNode* execute_rpc(path::ServiceProvider & provider, map<string, Entity*> entity_map,
 		const string & operation, const string & data_tag, bool set_config_flag=false);
-static unique_ptr<Entity> get_top_entity_from_filter(Entity & filter);
+static unique_ptr<path::Rpc> create_rpc(path::ServiceProvider & provider, const string & operation,
+		bool set_config_flag);
 static bool operation_succeeded(path::DataNode * node);
 
 CrudService::CrudService()
+	: executor(nullptr)
 {
 }
 
+CrudService::CrudService(TaskExecutor & executor)
+	: executor(&executor)
+{
+}
+
+TaskExecutor & CrudService::get_executor()
+{
+	return executor != nullptr ? *executor : get_default_executor();
+}
+
 bool CrudService::create(path::ServiceProvider & provider, Entity & entity)
 {
 	BOOST_LOG_TRIVIAL(debug) << "Executing CRUD create operation";
@@ -95,28 +110,95 @@ unique_ptr<Entity> CrudService::read(path::ServiceProvider & provider, Entity &
 {
 	BOOST_LOG_TRIVIAL(debug) << "Executing CRUD read operation";
 	path::DataNode* read_data_node = execute_rpc(provider, filter, "ydk:read", "filter");
-	return read(filter, read_data_node);
+	auto start = chrono::steady_clock::now();
+	unique_ptr<Entity> top_entity = read(filter, read_data_node);
+	provider.record_read_populate(false, chrono::steady_clock::now() - start);
+	return top_entity;
 }
 
 map<string, unique_ptr<Entity> > CrudService::read(path::ServiceProvider & provider, map<string, Entity*> filter_map)
 {
 	BOOST_LOG_TRIVIAL(debug) << "Executing CRUD read operation";
 	path::DataNode* read_data_node = execute_rpc(provider, filter_map, "ydk:read", "filter");
-	return read(filter_map, read_data_node);
+	auto start = chrono::steady_clock::now();
+	map<string, unique_ptr<Entity> > entities = read(filter_map, read_data_node);
+	provider.record_read_populate(false, chrono::steady_clock::now() - start);
+	return entities;
 }
 
 unique_ptr<Entity> CrudService::read_config(path::ServiceProvider & provider, Entity & filter)
 {
 	BOOST_LOG_TRIVIAL(debug) << "Executing CRUD config read operation";
 	path::DataNode* read_data_node = execute_rpc(provider, filter, "ydk:read", "filter", true);
-	return read(filter, read_data_node);
+	auto start = chrono::steady_clock::now();
+	unique_ptr<Entity> top_entity = read(filter, read_data_node);
+	provider.record_read_populate(true, chrono::steady_clock::now() - start);
+	return top_entity;
 }
 
 map<string, unique_ptr<Entity> > CrudService::read_config(path::ServiceProvider & provider, map<string, Entity*> filter_map)
 {
 	BOOST_LOG_TRIVIAL(debug) << "Executing CRUD config read operation";
 	path::DataNode* read_data_node = execute_rpc(provider, filter_map, "ydk:read", "filter", true);
-	return read(filter_map, read_data_node);
+	auto start = chrono::steady_clock::now();
+	map<string, unique_ptr<Entity> > entities = read(filter_map, read_data_node);
+	provider.record_read_populate(true, chrono::steady_clock::now() - start);
+	return entities;
+}
+
+future<bool> CrudService::create_async(path::ServiceProvider & provider, Entity & entity)
+{
+	return submit(get_executor(), [this, &provider, &entity]() { return create(provider, entity); });
+}
+
+void CrudService::create_async(path::ServiceProvider & provider, Entity & entity,
+		function<void(future<bool>)> callback)
+{
+	submit(get_executor(), [this, &provider, &entity]() { return create(provider, entity); }, callback);
+}
+
+future<bool> CrudService::update_async(path::ServiceProvider & provider, Entity & entity)
+{
+	return submit(get_executor(), [this, &provider, &entity]() { return update(provider, entity); });
+}
+
+void CrudService::update_async(path::ServiceProvider & provider, Entity & entity,
+		function<void(future<bool>)> callback)
+{
+	submit(get_executor(), [this, &provider, &entity]() { return update(provider, entity); }, callback);
+}
+
+future<bool> CrudService::delete_async(path::ServiceProvider & provider, Entity & entity)
+{
+	return submit(get_executor(), [this, &provider, &entity]() { return delete_(provider, entity); });
+}
+
+void CrudService::delete_async(path::ServiceProvider & provider, Entity & entity,
+		function<void(future<bool>)> callback)
+{
+	submit(get_executor(), [this, &provider, &entity]() { return delete_(provider, entity); }, callback);
+}
+
+future<unique_ptr<Entity>> CrudService::read_async(path::ServiceProvider & provider, Entity & filter)
+{
+	return submit(get_executor(), [this, &provider, &filter]() { return read(provider, filter); });
+}
+
+void CrudService::read_async(path::ServiceProvider & provider, Entity & filter,
+		function<void(future<unique_ptr<Entity>>)> callback)
+{
+	submit(get_executor(), [this, &provider, &filter]() { return read(provider, filter); }, callback);
+}
+
+future<unique_ptr<Entity>> CrudService::read_config_async(path::ServiceProvider & provider, Entity & filter)
+{
+	return submit(get_executor(), [this, &provider, &filter]() { return read_config(provider, filter); });
+}
+
+void CrudService::read_config_async(path::ServiceProvider & provider, Entity & filter,
+		function<void(future<unique_ptr<Entity>>)> callback)
+{
+	submit(get_executor(), [this, &provider, &filter]() { return read_config(provider, filter); }, callback);
 }
 
 unique_ptr<Entity> CrudService::read(Entity & filter, path::DataNode* read_data_node)
@@ -149,56 +231,92 @@ static bool operation_succeeded(path::DataNode * node)
 	return node == nullptr;
 }
 
-static unique_ptr<Entity> get_top_entity_from_filter(Entity & filter)
+path::DataNode* execute_crud_rpc(path::ServiceProvider & provider, const string & operation,
+		const string & data_tag, const string & data, bool set_config_flag)
 {
-	if(filter.parent == nullptr)
-		return filter.clone_ptr();
+	unique_ptr<path::Rpc> ydk_rpc = create_rpc(provider, operation, set_config_flag);
+	ydk_rpc->input()->create(data_tag, data);
+	return (*ydk_rpc)(provider);
+}
 
-	return get_top_entity_from_filter(*(filter.parent));
+path::DataNode* execute_crud_rpc(path::ServiceProvider & provider, const string & operation,
+		const string & data_tag, path::DataNode & data, bool set_config_flag)
+{
+	unique_ptr<path::Rpc> ydk_rpc = create_rpc(provider, operation, set_config_flag);
+	ydk_rpc->attach(data_tag, data);
+	return (*ydk_rpc)(provider);
 }
 
-static path::DataNode* execute_rpc(path::ServiceProvider & provider, Entity & entity,
-		const string & operation, const string & data_tag, bool set_config_flag)
+static unique_ptr<path::Rpc> create_rpc(path::ServiceProvider & provider, const string & operation,
+		bool set_config_flag)
 {
 	path::RootSchemaNode* root_schema = provider.get_root_schema();
-	unique_ptr<ydk::path::Rpc> ydk_rpc { root_schema->rpc(operation) };
-	string data = get_data_payload(entity, *root_schema);
+	unique_ptr<path::Rpc> ydk_rpc { root_schema->rpc(operation) };
+	if(ydk_rpc == nullptr)
+	{
+		BOOST_LOG_TRIVIAL(error) << "Cannot create payload for RPC: " << operation;
+		BOOST_THROW_EXCEPTION(YCPPIllegalStateError{"Cannot create payload for RPC: " + operation});
+	}
 
 	if(set_config_flag)
 	{
 		ydk_rpc->input()->create("only-config");
 	}
-	ydk_rpc->input()->create(data_tag, data);
+	return ydk_rpc;
+}
+
+static path::DataNode* execute_rpc(path::ServiceProvider & provider, Entity & entity,
+		const string & operation, const string & data_tag, bool set_config_flag)
+{
+	unique_ptr<path::Rpc> ydk_rpc = create_rpc(provider, operation, set_config_flag);
+	set_rpc_data(provider, *ydk_rpc, {&entity}, data_tag);
 	return (*ydk_rpc)(provider);
 }
 
 static path::DataNode* execute_rpc(path::ServiceProvider & provider, map<string, Entity*> entity_map,
 		const string & operation, const string & data_tag, bool set_config_flag)
 {
-	path::RootSchemaNode* root_schema = provider.get_root_schema();
-	unique_ptr<ydk::path::Rpc> ydk_rpc { root_schema->rpc(operation) };
-	string data;
+	unique_ptr<path::Rpc> ydk_rpc = create_rpc(provider, operation, set_config_flag);
+	vector<Entity*> entities;
 
 	for(auto entry : entity_map)
 	{
-	    data += get_data_payload(*(entry.second), *root_schema);
+	    entities.push_back(entry.second);
 	}
 
-	BOOST_LOG_TRIVIAL(debug) << "Payload to be sent in RPC";
-    BOOST_LOG_TRIVIAL(debug) << data<<endl;
+	set_rpc_data(provider, *ydk_rpc, entities, data_tag);
 
-	if(set_config_flag)
+	return (*ydk_rpc)(provider);
+}
+
+static void set_rpc_data(path::ServiceProvider & provider, path::Rpc & rpc, const vector<Entity*> & entities,
+		const string & data_tag)
+{
+	path::RootSchemaNode & root_schema = *provider.get_root_schema();
+
+	// providers using the data trees directly spare the encode to the anyxml and the decode back
+	if(provider.supports_attached_data(data_tag))
 	{
-		ydk_rpc->input()->create("only-config");
+		for(auto entity : entities)
+		{
+			path::DataNode* data_node = get_data_node_from_entity(*entity, root_schema);
+			if(data_node != nullptr)
+			{
+				rpc.attach(data_tag, *data_node);
+			}
+		}
+		return;
 	}
-	ydk_rpc->input()->create(data_tag, data);
 
-    path::CodecService codec{};
-    string pl = codec.encode(ydk_rpc->input(), ydk::path::CodecService::Format::XML, true);
-    BOOST_LOG_TRIVIAL(debug) << "Payload to be sent in RPC";
-    BOOST_LOG_TRIVIAL(debug) << data<<endl;
+	string data;
+	for(auto entity : entities)
+	{
+		data += get_data_payload(*entity, root_schema);
+	}
 
-	return (*ydk_rpc)(provider);
+	BOOST_LOG_TRIVIAL(debug) << "Payload to be sent in RPC";
+	BOOST_LOG_TRIVIAL(debug) << data<<endl;
+	rpc.input()->create(data_tag, data);
 }
 
 static string get_data_payload(Entity & entity, path::RootSchemaNode & root_schema)
@@ -28,10 +28,13 @@
 #ifndef CRUD_SERVICE_HPP
 #define CRUD_SERVICE_HPP
 
+#include <functional>
+#include <future>
 #include <map>
 #include <memory>
 #include <string>
 #include "service.hpp"
+#include "task_executor.hpp"
 
 namespace ydk
 {
@@ -48,6 +51,7 @@ class CrudService : public Service
 {
 	public:
 		CrudService();
+		explicit CrudService(TaskExecutor & executor);
 
 		bool create(path::ServiceProvider & provider, Entity & entity);
 		bool create(path::ServiceProvider & provider, std::map<std::string, Entity*> entity_map);
@@ -64,11 +68,49 @@ class CrudService : public Service
 		std::unique_ptr<Entity> read_config(path::ServiceProvider & provider, Entity & filter);
 		std::map<std::string, std::unique_ptr<Entity> > read_config(path::ServiceProvider & provider, std::map<std::string, Entity*> entity);
 
+		// Asynchronous variants run on the service's executor. The provider and the
+		// entity must outlive the returned future or the call of the callback.
+		std::future<bool> create_async(path::ServiceProvider & provider, Entity & entity);
+		void create_async(path::ServiceProvider & provider, Entity & entity,
+				std::function<void(std::future<bool>)> callback);
+
+		std::future<bool> update_async(path::ServiceProvider & provider, Entity & entity);
+		void update_async(path::ServiceProvider & provider, Entity & entity,
+				std::function<void(std::future<bool>)> callback);
+
+		std::future<bool> delete_async(path::ServiceProvider & provider, Entity & entity);
+		void delete_async(path::ServiceProvider & provider, Entity & entity,
+				std::function<void(std::future<bool>)> callback);
+
+		std::future<std::unique_ptr<Entity>> read_async(path::ServiceProvider & provider, Entity & filter);
+		void read_async(path::ServiceProvider & provider, Entity & filter,
+				std::function<void(std::future<std::unique_ptr<Entity>>)> callback);
+
+		std::future<std::unique_ptr<Entity>> read_config_async(path::ServiceProvider & provider, Entity & filter);
+		void read_config_async(path::ServiceProvider & provider, Entity & filter,
+				std::function<void(std::future<std::unique_ptr<Entity>>)> callback);
+
 	private:
 		std::unique_ptr<Entity> read(Entity & filter, path::DataNode* read_data_node);
 		std::map<std::string, std::unique_ptr<Entity> > read(std::map<std::string, Entity*> filter_map, path::DataNode* read_data_node);
+
+	private:
+		TaskExecutor & get_executor();
+
+	private:
+		// null for the services using the default executor, which the first asynchronous call starts
+		TaskExecutor* executor;
 };
 
+// Runs the CRUD rpc with the entities already encoded in data, for the callers
+// encoding a payload once and sending it to several providers.
+path::DataNode* execute_crud_rpc(path::ServiceProvider & provider, const std::string & operation,
+		const std::string & data_tag, const std::string & data, bool set_config_flag = false);
+// As above with the entities already converted to a data tree, attached to the rpc for the
+// providers supporting it; the tree is only read, so several providers can share it.
+path::DataNode* execute_crud_rpc(path::ServiceProvider & provider, const std::string & operation,
+		const std::string & data_tag, path::DataNode & data, bool set_config_flag = false);
+
 }
 
 #endif /* CRUD_SERVICE_HPP */
@@ -47,7 +47,6 @@ static void walk_children(Entity & entity, path::DataNode* data_node);
 static void populate_name_values(path::DataNode* parent_data_node, EntityPath & path);
 static bool data_node_is_leaf(path::DataNode* data_node);
 static bool data_node_is_list(path::DataNode* data_node);
-static string get_segment_path(const string & path);
 static void add_annotation_to_datanode(const Entity & entity, path::DataNode & data_node);
 static void add_annotation_to_datanode(const std::pair<std::string, LeafData> & name_value, path::DataNode & data_node);
 static path::Annotation get_annotation(EditOperation operation);
@@ -177,6 +176,8 @@ void get_entity_from_data_node(path::DataNode * node, Entity* entity)
 	if (entity == nullptr || node == nullptr)
 		return;
 
+	// reused by the list entries, their segments are only needed to look up the child entity
+	std::string segment_path;
 	for(path::DataNode* child_data_node:node->children())
 	{
 		std::string child_name = child_data_node->schema()->statement().arg;
@@ -192,7 +193,9 @@ void get_entity_from_data_node(path::DataNode * node, Entity* entity)
 			Entity * child_entity;
 			if(data_node_is_list(child_data_node))
 			{
-				child_entity = entity->get_child_by_name(child_name, get_segment_path(child_data_node->path()));
+				segment_path.clear();
+				child_data_node->append_segment(segment_path);
+				child_entity = entity->get_child_by_name(child_name, segment_path);
 			}
 			else
 			{
@@ -208,6 +211,14 @@ void get_entity_from_data_node(path::DataNode * node, Entity* entity)
 	}
 }
 
+unique_ptr<Entity> get_top_entity_from_filter(Entity & filter)
+{
+	if(filter.parent == nullptr)
+		return filter.clone_ptr();
+
+	return get_top_entity_from_filter(*(filter.parent));
+}
+
 static bool data_node_is_leaf(path::DataNode* data_node)
 {
 	return (data_node->schema()->statement().keyword == "leaf"
@@ -219,10 +230,4 @@ static bool data_node_is_list(path::DataNode* data_node)
 	return (data_node->schema()->statement().keyword == "list");
 }
 
-static string get_segment_path(const string & path)
-{
-	std::vector<std::string> segments = path::segmentalize(path);
-	return segments.back();
-}
-
 }
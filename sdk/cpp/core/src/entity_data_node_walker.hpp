@@ -30,6 +30,7 @@
 
 #include <vector>
 #include <map>
+#include <memory>
 #include "path_api.hpp"
 
 namespace ydk {
@@ -41,5 +42,7 @@ path::DataNode* get_data_node_from_entity(Entity & entity, const path::RootSchem
 
 void get_entity_from_data_node(path::DataNode * node, Entity* entity);
 
+std::unique_ptr<Entity> get_top_entity_from_filter(Entity & filter);
+
 }
 #endif /* WALKER_HPP */
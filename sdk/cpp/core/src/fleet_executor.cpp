@@ -0,0 +1,297 @@
+/// YANG Development Kit
+// Copyright 2016 Cisco Systems. All rights reserved
+//
+////////////////////////////////////////////////////////////////
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+//
+//////////////////////////////////////////////////////////////////
+
+#include <atomic>
+#include <condition_variable>
+#include <map>
+#include <mutex>
+
+#include <boost/log/trivial.hpp>
+
+#include "crud_service.hpp"
+#include "entity_data_node_walker.hpp"
+#include "errors.hpp"
+#include "fleet_executor.hpp"
+#include "netconf_provider.hpp"
+#include "path_api.hpp"
+#include "types.hpp"
+
+using namespace std;
+
+namespace ydk {
+
+std::string get_data_payload(Entity & entity, path::RootSchemaNode & root_schema);
+
+namespace
+{
+// the entity for one schema: the data tree shared by the providers taking attached data,
+// the xml for the others
+struct SchemaPayload
+{
+	unique_ptr<const path::DataNode> tree;
+	path::DataNode* data_node = nullptr;
+	string data;
+	string error;
+	exception_ptr exception;
+};
+
+// Shared by the workers, so that a worker the executor only starts once all devices are done
+// finds the run still there. The references to the caller's arguments are only used while
+// a device is being served, which the caller waits for.
+struct FleetRun
+{
+	FleetRun(const vector<NetconfServiceProvider*> & providers, FleetOperation operation, Entity & entity,
+			const FleetExecutor::ResultCallback & callback)
+		: providers(providers), count(providers.size()), operation(operation), entity(entity), callback(callback),
+		  next(0), completed(0)
+	{
+	}
+
+	const vector<NetconfServiceProvider*> & providers;
+	size_t count;
+	FleetOperation operation;
+	Entity & entity;
+	const FleetExecutor::ResultCallback & callback;
+	map<path::RootSchemaNode*, SchemaPayload> payloads;
+
+	atomic<size_t> next;
+	mutex callback_mutex;
+	mutex done_mutex;
+	condition_variable done;
+	size_t completed;
+};
+}
+
+static void prepare_payload(FleetRun & run, path::RootSchemaNode & root_schema, SchemaPayload & payload);
+static void run_worker(FleetRun & run);
+static FleetResult run_on_device(FleetRun & run, size_t index);
+static string get_operation_name(FleetOperation operation);
+static bool is_read(FleetOperation operation);
+
+FleetExecutor::FleetExecutor(TaskExecutor & executor, size_t max_concurrency)
+	: executor(executor), max_concurrency(max_concurrency == 0 ? executor.concurrency() : max_concurrency)
+{
+	this->max_concurrency = max<size_t>(this->max_concurrency, 1);
+}
+
+void FleetExecutor::execute(const vector<NetconfServiceProvider*> & providers, FleetOperation operation,
+		Entity & entity, ResultCallback callback)
+{
+	BOOST_LOG_TRIVIAL(debug) << "Executing fleet operation on " << providers.size() << " device(s)";
+	if(providers.empty())
+	{
+		return;
+	}
+	auto run = make_shared<FleetRun>(providers, operation, entity, callback);
+
+	// the payload only depends on the schema, providers sharing one share it
+	for(auto provider : providers)
+	{
+		path::RootSchemaNode* root_schema = provider->get_root_schema();
+		if(run->payloads.find(root_schema) == run->payloads.end())
+		{
+			prepare_payload(*run, *root_schema, run->payloads[root_schema]);
+		}
+	}
+	BOOST_LOG_TRIVIAL(debug) << "Prepared payload for " << run->payloads.size() << " distinct schema(s)";
+
+	// the calling thread is one of the workers
+	size_t workers = min(max_concurrency, providers.size());
+	for(size_t i = 1; i < workers; ++i)
+	{
+		executor.post([run]() { run_worker(*run); });
+	}
+	run_worker(*run);
+
+	unique_lock<mutex> lock{run->done_mutex};
+	run->done.wait(lock, [&run]() { return run->completed == run->count; });
+}
+
+vector<FleetResult> FleetExecutor::execute(const vector<NetconfServiceProvider*> & providers,
+		FleetOperation operation, Entity & entity)
+{
+	vector<FleetResult> results(providers.size());
+	execute(providers, operation, entity, [&results](FleetResult result) {
+		size_t index = result.index;
+		results[index] = move(result);
+	});
+	return results;
+}
+
+static void prepare_payload(FleetRun & run, path::RootSchemaNode & root_schema, SchemaPayload & payload)
+{
+	string data_tag = is_read(run.operation) ? "filter" : "entity";
+	bool attach = true;
+	for(auto provider : run.providers)
+	{
+		if(provider->get_root_schema() == &root_schema && !provider->supports_attached_data(data_tag))
+		{
+			attach = false;
+			break;
+		}
+	}
+
+	try
+	{
+		if(attach)
+		{
+			payload.data_node = get_data_node_from_entity(run.entity, root_schema);
+			if(payload.data_node != nullptr)
+			{
+				payload.tree.reset(payload.data_node->root());
+			}
+		}
+		else
+		{
+			payload.data = get_data_payload(run.entity, root_schema);
+		}
+	}
+	catch(const exception & e)
+	{
+		payload.error = e.what();
+		payload.exception = current_exception();
+	}
+	catch(...)
+	{
+		payload.error = "unknown error";
+		payload.exception = current_exception();
+	}
+}
+
+static void run_worker(FleetRun & run)
+{
+	for(size_t index = run.next++; index < run.count; index = run.next++)
+	{
+		FleetResult result = run_on_device(run, index);
+		{
+			lock_guard<mutex> lock{run.callback_mutex};
+			try
+			{
+				run.callback(move(result));
+			}
+			catch(const exception & e)
+			{
+				BOOST_LOG_TRIVIAL(error) << "Fleet result callback failed: " << e.what();
+			}
+			catch(...)
+			{
+				BOOST_LOG_TRIVIAL(error) << "Fleet result callback failed with an unknown error";
+			}
+		}
+		// notifies under the lock, the caller returns as soon as it sees the last device done
+		lock_guard<mutex> lock{run.done_mutex};
+		++run.completed;
+		run.done.notify_all();
+	}
+}
+
+static FleetResult run_on_device(FleetRun & run, size_t index)
+{
+	NetconfServiceProvider* provider = run.providers[index];
+	FleetResult result{};
+	result.index = index;
+	result.provider = provider;
+	result.ok = false;
+
+	auto start = chrono::steady_clock::now();
+	const SchemaPayload & payload = run.payloads.at(provider->get_root_schema());
+	if(payload.exception)
+	{
+		result.error = payload.error;
+		result.exception = payload.exception;
+	}
+	else
+	{
+		try
+		{
+			string operation = get_operation_name(run.operation);
+			string data_tag = is_read(run.operation) ? "filter" : "entity";
+			bool only_config = (run.operation == FleetOperation::read_config);
+			path::DataNode* reply = nullptr;
+			if(payload.data_node != nullptr)
+			{
+				reply = execute_crud_rpc(*provider, operation, data_tag, *payload.data_node, only_config);
+			}
+			else
+			{
+				reply = execute_crud_rpc(*provider, operation, data_tag, payload.data, only_config);
+			}
+
+			if(is_read(run.operation))
+			{
+				if(reply != nullptr && !reply->children().empty())
+				{
+					result.entity = get_top_entity_from_filter(run.entity);
+					get_entity_from_data_node(reply->children()[0], result.entity.get());
+				}
+				else if(reply != nullptr)
+				{
+					BOOST_LOG_TRIVIAL(debug) << "Fleet read returned no data on device " << index;
+				}
+				result.ok = true;
+			}
+			else
+			{
+				result.ok = (reply == nullptr);
+			}
+		}
+		catch(const exception & e)
+		{
+			BOOST_LOG_TRIVIAL(debug) << "Fleet operation failed on device " << index << ": " << e.what();
+			result.error = e.what();
+			result.exception = current_exception();
+		}
+		catch(...)
+		{
+			BOOST_LOG_TRIVIAL(debug) << "Fleet operation failed on device " << index << " with an unknown error";
+			result.error = "unknown error";
+			result.exception = current_exception();
+		}
+	}
+	result.latency = chrono::duration_cast<chrono::microseconds>(chrono::steady_clock::now() - start);
+	return result;
+}
+
+static bool is_read(FleetOperation operation)
+{
+	return operation == FleetOperation::read || operation == FleetOperation::read_config;
+}
+
+static string get_operation_name(FleetOperation operation)
+{
+	switch(operation)
+	{
+		case FleetOperation::create:
+			return "ydk:create";
+		case FleetOperation::update:
+			return "ydk:update";
+		case FleetOperation::delete_:
+			return "ydk:delete";
+		case FleetOperation::read:
+		case FleetOperation::read_config:
+			return "ydk:read";
+	}
+	return "";
+}
+
+}
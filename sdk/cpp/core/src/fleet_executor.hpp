@@ -0,0 +1,95 @@
+//
+// @file fleet_executor.hpp
+// @brief Runs one CRUD operation across many devices.
+//
+// YANG Development Kit
+// Copyright 2016 Cisco Systems. All rights reserved
+//
+////////////////////////////////////////////////////////////////
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+//
+//////////////////////////////////////////////////////////////////
+
+
+#ifndef FLEET_EXECUTOR_HPP
+#define FLEET_EXECUTOR_HPP
+
+#include <chrono>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+#include "task_executor.hpp"
+
+namespace ydk
+{
+
+class Entity;
+class NetconfServiceProvider;
+
+enum class FleetOperation {
+	create,
+	update,
+	delete_,
+	read,
+	read_config
+};
+
+struct FleetResult
+{
+	// position of the provider in the list passed to the executor
+	std::size_t index;
+	NetconfServiceProvider* provider;
+	bool ok;
+	// entity read from the device, for read and read_config; nullptr if the device had no data
+	std::unique_ptr<Entity> entity;
+	std::chrono::microseconds latency;
+	std::string error;
+	std::exception_ptr exception;
+};
+
+// Runs one CRUD operation against a list of devices. The entity is converted to a data tree
+// once per distinct schema the providers use, which the providers supporting attached data
+// share; the others get it encoded once per schema. The devices are served by at most
+// max_concurrency workers, the calling thread and tasks on the executor, each picking the
+// next device as it gets idle. The calling thread serves devices too, so executing from a
+// task running on the executor cannot deadlock, it only gets fewer workers.
+class FleetExecutor
+{
+	public:
+		typedef std::function<void(FleetResult result)> ResultCallback;
+
+		// max_concurrency 0 is the number of threads of the executor
+		explicit FleetExecutor(TaskExecutor & executor = get_default_executor(), std::size_t max_concurrency = 0);
+
+		// Blocks until all devices are done. The callback receives the result of each device
+		// as soon as it completes; calls are serialized but come from the workers' threads.
+		void execute(const std::vector<NetconfServiceProvider*> & providers, FleetOperation operation,
+				Entity & entity, ResultCallback callback);
+		std::vector<FleetResult> execute(const std::vector<NetconfServiceProvider*> & providers,
+				FleetOperation operation, Entity & entity);
+
+	private:
+		TaskExecutor & executor;
+		std::size_t max_concurrency;
+};
+
+}
+
+#endif /* FLEET_EXECUTOR_HPP */
@@ -23,6 +23,7 @@
 
 
 #include <iostream>
+#include <mutex>
 #include <sstream>
 #include <stdio.h>
 
@@ -32,6 +33,9 @@
 
 
 #include "netconf_client.hpp"
+#include "netconf_stats.hpp"
+#include "startup_profile.hpp"
+#include "netconf_transport.hpp"
 
 using namespace std;
 using namespace ydk;
@@ -41,36 +45,96 @@ typedef vector<string> StringVec;
 namespace ydk
 {
 
-map<pair<string, string>, string> NetconfClient::password_lookup;
-
 NetconfClient::NetconfClient(string  username, string  password,
 		string  hostname, int port, int verbosity) :
-		username(username), hostname(hostname), port(port)
+		NetconfClient(unique_ptr<NetconfTransport>{new SshTransport{username, password, hostname, port}}, verbosity)
 {
-	nc_verbosity((NC_VERB_LEVEL) verbosity);
-	nc_callback_print(clb_print);
-	nc_callback_sshauth_password(clb_set_password);
-	nc_callback_ssh_host_authenticity_check(clb_ssh_host_authenticity_check);
+}
+
+NetconfClient::NetconfClient(unique_ptr<NetconfTransport> transport, int verbosity) :
+		transport(move(transport)), stats(nullptr)
+{
+	hostname = this->transport->get_hostname();
+
+	static once_flag callbacks_registered;
+	call_once(callbacks_registered, register_callbacks);
 
-	password_lookup.insert(make_pair(make_pair(username, hostname), password));
+	nc_verbosity((NC_VERB_LEVEL) verbosity);
 	session=NULL;
 }
 
-
+void NetconfClient::register_callbacks()
+{
+	nc_callback_print(clb_print);
+}
 
 int NetconfClient::connect()
 {
-	session = nc_session_connect(hostname.c_str(), port, username.c_str(), NULL);
+	{
+		// libnetconf performs the SSH handshake and the hello exchange in one call
+		StartupPhaseTimer timer{"connect", transport->get_hostname_port()};
+		session = transport->connect();
+	}
 	perform_session_check("Could not connect to " + hostname);
-	init_capabilities();
+	{
+		StartupPhaseTimer timer{"capabilities", transport->get_hostname_port()};
+		init_capabilities();
+	}
 	return EXIT_SUCCESS;
 }
 
 std::string NetconfClient::get_hostname_port()
 {
-	ostringstream os;
-	os<<hostname<<":"<<port;
-	return os.str();
+	return transport->get_hostname_port();
+}
+
+bool NetconfClient::is_connected()
+{
+	return session != NULL && nc_session_get_status(session) == NC_SESSION_STATUS_WORKING;
+}
+
+bool NetconfClient::is_alive()
+{
+	if(!is_connected())
+	{
+		return false;
+	}
+
+	try
+	{
+		// an empty subtree filter selects nothing, the reply is an empty data element
+		NetconfReply reply = execute(
+				"<rpc xmlns=\"urn:ietf:params:xml:ns:netconf:base:1.0\">"
+				"<get><filter type=\"subtree\"></filter></get>"
+				"</rpc>");
+		return reply.contains("<data");
+	}
+	catch(YCPPError & e)
+	{
+		BOOST_LOG_TRIVIAL(debug) << "Keepalive to " << get_hostname_port() << " failed: " << e.err_msg;
+		return false;
+	}
+}
+
+void NetconfClient::reconnect()
+{
+	BOOST_LOG_TRIVIAL(debug) << "Reconnecting to " << get_hostname_port();
+	for(auto & pending : pending_replies)
+	{
+		nc_reply_free(pending.second);
+	}
+	pending_replies.clear();
+	outstanding_rpcs.clear();
+	abandoned_ids.clear();
+	capabilities.clear();
+
+	if(session != NULL)
+	{
+		nc_session_free(session);
+		session = NULL;
+		transport->disconnect();
+	}
+	connect();
 }
 
 void NetconfClient::init_capabilities()
@@ -87,15 +151,85 @@ void NetconfClient::init_capabilities()
 	}
 }
 
+void NetconfClient::create_subscription(const string & stream, const string & filter)
+{
+	perform_session_check("Could not subscribe. Not connected to " + hostname);
+
+	struct nc_filter* subtree_filter = NULL;
+	if(!filter.empty())
+	{
+		subtree_filter = nc_filter_new(NC_FILTER_SUBTREE, filter.c_str());
+	}
+	nc_rpc* rpc = ncntf_rpc_create_subscription(stream.empty() ? NULL : stream.c_str(), subtree_filter, NULL, NULL);
+	if(subtree_filter != NULL)
+	{
+		nc_filter_free(subtree_filter);
+	}
+	if(rpc == NULL)
+	{
+		BOOST_LOG_TRIVIAL(error) << "Could not build subscription rpc for stream " << stream;
+		BOOST_THROW_EXCEPTION(YCPPClientError{"Could not build subscription rpc"});
+	}
+
+	nc_reply *reply = NULL;
+	NC_MSG_TYPE reply_type = nc_session_send_recv(session, rpc, &reply);
+	nc_rpc_free(rpc);
+	NetconfReply reply_payload = process_rpc_reply(reply_type, reply);
+	nc_reply_free(reply);
+
+	if(!reply_payload.contains("<ok/>"))
+	{
+		BOOST_LOG_TRIVIAL(error) << "Subscription to stream " << stream << " failed: " << reply_payload.c_str();
+		BOOST_THROW_EXCEPTION(YCPPClientError{reply_payload.str()});
+	}
+	BOOST_LOG_TRIVIAL(debug) << "Subscribed to stream " << stream << " on " << get_hostname_port();
+}
+
+bool NetconfClient::receive_notification(int timeout_ms, string & content, time_t & event_time)
+{
+	perform_session_check("Could not receive notification. Not connected to " + hostname);
+
+	nc_ntf* notification = NULL;
+	NC_MSG_TYPE type = nc_session_recv_notif(session, timeout_ms, &notification);
+	if(type == NC_MSG_WOULDBLOCK)
+	{
+		return false;
+	}
+	else if(type != NC_MSG_NOTIFICATION)
+	{
+		BOOST_LOG_TRIVIAL(error) << "Error occurred while receiving notifications from " << get_hostname_port();
+		BOOST_THROW_EXCEPTION(YCPPClientError{"Error occurred while receiving notifications"});
+	}
+
+	char* notification_content = ncntf_notif_get_content(notification);
+	content = notification_content != NULL ? notification_content : "";
+	free(notification_content);
+	event_time = ncntf_notif_get_time(notification);
+	ncntf_notif_free(notification);
+	return true;
+}
+
 string NetconfClient::execute_payload(const string & payload)
+{
+	return execute(payload).str();
+}
+
+NetconfReply NetconfClient::execute(const string & payload)
 {
 	perform_session_check("Could not execute payload. Not connected to " + hostname);
 
+	if(!outstanding_rpcs.empty() || !abandoned_ids.empty() || (stats != nullptr && stats->is_enabled()))
+	{
+		//pipelined rpcs are in flight or abandoned replies are still due, the reply has to be
+		//matched by message-id; the rpc is also split into its phases when they are being timed
+		return collect(send_payload(payload));
+	}
+
 	nc_reply *reply;
 	nc_rpc *rpc = build_rpc_request(payload);
 
 	NC_MSG_TYPE reply_type = nc_session_send_recv(session, rpc, &reply);
-	string reply_payload = process_rpc_reply(reply_type, reply);
+	NetconfReply reply_payload = process_rpc_reply(reply_type, reply);
 
 	nc_reply_free(reply);
 	nc_rpc_free(rpc);
@@ -103,9 +237,219 @@ string NetconfClient::execute_payload(const string & payload)
 	return reply_payload;
 }
 
+string NetconfClient::send_payload(const string & payload)
+{
+	perform_session_check("Could not send payload. Not connected to " + hostname);
+
+	string rpc_name = stats != nullptr && stats->is_enabled() ? get_rpc_name(payload) : string{};
+	nc_rpc *rpc = NULL;
+	{
+		RpcPhaseTimer timer{stats, rpc_name, RpcPhase::build};
+		timer.set_bytes(payload.size(), 0);
+		rpc = build_rpc_request(payload);
+	}
+
+	nc_msgid msgid = NULL;
+	{
+		RpcPhaseTimer timer{stats, rpc_name, RpcPhase::send};
+		timer.set_bytes(payload.size(), 0);
+		msgid = nc_session_send_rpc(session, rpc);
+	}
+	if(msgid == NULL)
+	{
+		nc_rpc_free(rpc);
+		BOOST_LOG_TRIVIAL(error) << "Could not send rpc to " << hostname;
+		BOOST_THROW_EXCEPTION(YCPPClientError{"Could not send rpc"});
+	}
+
+	string message_id{msgid};
+	nc_rpc_free(rpc);
+
+	outstanding_rpcs[message_id] = OutstandingRpc{rpc_name, payload.size(), chrono::steady_clock::now()};
+	BOOST_LOG_TRIVIAL(trace) << "Sent rpc with message-id " << message_id;
+	return message_id;
+}
+
+string NetconfClient::collect_reply(const string & message_id)
+{
+	return collect(message_id).str();
+}
+
+NetconfReply NetconfClient::collect(const string & message_id)
+{
+	if(outstanding_rpcs.find(message_id) == outstanding_rpcs.end())
+	{
+		BOOST_LOG_TRIVIAL(error) << "No rpc in flight with message-id " << message_id;
+		BOOST_THROW_EXCEPTION(YCPPClientError{"No rpc in flight with message-id " + message_id});
+	}
+
+	nc_reply *reply = receive_reply(message_id);
+	return dump_reply(message_id, reply);
+}
+
+StringVec NetconfClient::execute_payloads(const StringVec & payloads, size_t max_in_flight)
+{
+	StringVec replies{};
+	deque<string> in_flight{};
+	max_in_flight = max(max_in_flight, static_cast<size_t>(1));
+
+	try
+	{
+		for(auto & payload : payloads)
+		{
+			if(in_flight.size() == max_in_flight)
+			{
+				replies.push_back(collect_reply(in_flight.front()));
+				in_flight.pop_front();
+			}
+			in_flight.push_back(send_payload(payload));
+		}
+
+		while(!in_flight.empty())
+		{
+			replies.push_back(collect_reply(in_flight.front()));
+			in_flight.pop_front();
+		}
+	}
+	catch(...)
+	{
+		abandon_replies({in_flight.begin(), in_flight.end()});
+		throw;
+	}
+
+	return replies;
+}
+
+bool NetconfClient::poll_reply(string & message_id, string & reply_payload)
+{
+	nc_reply *reply = NULL;
+	if(!pending_replies.empty())
+	{
+		message_id = pending_replies.begin()->first;
+		reply = pending_replies.begin()->second;
+		pending_replies.erase(pending_replies.begin());
+	}
+	else
+	{
+		perform_session_check("Could not receive reply. Not connected to " + hostname);
+		while(true)
+		{
+			NC_MSG_TYPE reply_type = nc_session_recv_reply(session, 0, &reply);
+			if(reply_type == NC_MSG_WOULDBLOCK)
+			{
+				return false;
+			}
+			else if(reply_type == NC_MSG_NOTIFICATION)
+			{
+				continue;
+			}
+			else if(reply_type != NC_MSG_REPLY)
+			{
+				BOOST_LOG_TRIVIAL(error) << "RPC error occurred while polling " << hostname;
+				BOOST_THROW_EXCEPTION(YCPPClientError{"RPC error occured"});
+			}
+
+			const nc_msgid reply_id = nc_reply_get_msgid(reply);
+			message_id = reply_id != NULL ? reply_id : "";
+			if(abandoned_ids.erase(message_id) > 0)
+			{
+				nc_reply_free(reply);
+				continue;
+			}
+			break;
+		}
+	}
+
+	reply_payload = dump_reply(message_id, reply).str();
+	return true;
+}
+
+int NetconfClient::get_event_fd()
+{
+	perform_session_check("Not connected to " + hostname);
+	return nc_session_get_eventfd(session);
+}
+
+nc_reply* NetconfClient::receive_reply(const string & message_id)
+{
+	auto pending = pending_replies.find(message_id);
+	if(pending != pending_replies.end())
+	{
+		nc_reply *reply = pending->second;
+		pending_replies.erase(pending);
+		return reply;
+	}
+
+	perform_session_check("Could not receive reply. Not connected to " + hostname);
+
+	while(true)
+	{
+		nc_reply *reply = NULL;
+		NC_MSG_TYPE reply_type = nc_session_recv_reply(session, -1, &reply);
+		if(reply_type == NC_MSG_WOULDBLOCK || reply_type == NC_MSG_NOTIFICATION)
+		{
+			continue;
+		}
+		else if(reply_type != NC_MSG_REPLY)
+		{
+			BOOST_LOG_TRIVIAL(error) << "RPC error occurred while waiting for message-id " << message_id;
+			BOOST_THROW_EXCEPTION(YCPPClientError{"RPC error occured"});
+		}
+
+		const nc_msgid reply_id = nc_reply_get_msgid(reply);
+		string received_id{reply_id != NULL ? reply_id : ""};
+		if(received_id == message_id)
+		{
+			return reply;
+		}
+
+		if(abandoned_ids.erase(received_id) > 0)
+		{
+			nc_reply_free(reply);
+			continue;
+		}
+		if(outstanding_rpcs.find(received_id) == outstanding_rpcs.end())
+		{
+			// no rpc waits for it, holding it back would keep it for the life of the session
+			BOOST_LOG_TRIVIAL(warning) << "Dropping reply with unknown message-id " << received_id;
+			nc_reply_free(reply);
+			continue;
+		}
+
+		BOOST_LOG_TRIVIAL(trace) << "Holding back reply with message-id " << received_id;
+		pending_replies[received_id] = reply;
+	}
+}
+
+void NetconfClient::abandon_replies(const StringVec & message_ids)
+{
+	for(auto & message_id : message_ids)
+	{
+		outstanding_rpcs.erase(message_id);
+		auto pending = pending_replies.find(message_id);
+		if(pending != pending_replies.end())
+		{
+			nc_reply_free(pending->second);
+			pending_replies.erase(pending);
+		}
+		else
+		{
+			abandoned_ids.insert(message_id);
+		}
+	}
+}
+
 NetconfClient::~NetconfClient()
 {
-	nc_session_free(session);
+	for(auto & pending : pending_replies)
+	{
+		nc_reply_free(pending.second);
+	}
+	if(session != NULL)
+	{
+		nc_session_free(session);
+		transport->disconnect();
+	}
 }
 
 nc_rpc* NetconfClient::build_rpc_request(const string & payload)
@@ -126,12 +470,12 @@ nc_rpc* NetconfClient::build_rpc_request(const string & payload)
 	return rpc;
 }
 
-string NetconfClient::process_rpc_reply(int reply_type, const nc_reply* reply)
+NetconfReply NetconfClient::process_rpc_reply(int reply_type, const nc_reply* reply)
 {
 	switch (reply_type)
 	{
 		case NC_MSG_REPLY:
-			return nc_reply_dump(reply);
+			return NetconfReply{nc_reply_dump(reply)};
 
 		default:
 		case NC_MSG_NONE:
@@ -142,6 +486,33 @@ string NetconfClient::process_rpc_reply(int reply_type, const nc_reply* reply)
 	return {};
 }
 
+NetconfReply NetconfClient::dump_reply(const string & message_id, nc_reply* reply)
+{
+	auto received = chrono::steady_clock::now();
+	NetconfReply reply_payload = process_rpc_reply(NC_MSG_REPLY, reply);
+	nc_reply_free(reply);
+
+	auto outstanding = outstanding_rpcs.find(message_id);
+	if(outstanding == outstanding_rpcs.end())
+	{
+		return reply_payload;
+	}
+
+	const OutstandingRpc & rpc = outstanding->second;
+	if(stats != nullptr && !rpc.name.empty())
+	{
+		stats->record(rpc.name, RpcPhase::wait, received - rpc.sent, rpc.request_bytes, reply_payload.size());
+		stats->record(rpc.name, RpcPhase::dump, chrono::steady_clock::now() - received, rpc.request_bytes, reply_payload.size());
+	}
+	outstanding_rpcs.erase(outstanding);
+	return reply_payload;
+}
+
+void NetconfClient::set_stats(NetconfStats * stats)
+{
+	this->stats = stats;
+}
+
 StringVec NetconfClient::get_capabilities()
 {
 	return capabilities;
@@ -166,24 +537,6 @@ void NetconfClient::clb_print(NC_VERB_LEVEL level, const char* msg)
 	}
 }
 
-char* NetconfClient::clb_set_password(const char* user_name,
-		const char* host_name)
-{
-	string password_string = password_lookup[make_pair(user_name, host_name)];
-	char* password_buffer = (char*) malloc(
-			sizeof(char) * (password_string.size() + 1));
-	snprintf(password_buffer, password_string.size() + 1, "%s",
-			password_string.c_str());
-
-	return password_buffer;
-}
-
-int NetconfClient::clb_ssh_host_authenticity_check(const char *hostname,
-		ssh_session session)
-{
-	return EXIT_SUCCESS;
-}
-
 void NetconfClient::perform_session_check(string message)
 {
 	if (session == NULL)
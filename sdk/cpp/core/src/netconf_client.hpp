@@ -16,13 +16,19 @@
 
 #ifndef _YDK_NETCONF_CLIENT_H_
 #define _YDK_NETCONF_CLIENT_H_
+#include <chrono>
+#include <deque>
 #include <map>
+#include <memory>
+#include <set>
 #include <string>
+#include <time.h>
 #include <vector>
 
 #include <libnetconf/netconf.h>
 
 #include "errors.hpp"
+#include "netconf_reply.hpp"
 
 struct nc_session;
 typedef struct nc_msg nc_rpc;
@@ -37,6 +43,8 @@ typedef struct capabilities {
 
 namespace ydk
 {
+class NetconfStats;
+class NetconfTransport;
 
 struct YCPPClientError : public YCPPError
 {
@@ -51,42 +59,89 @@ class NetconfClient
 {
 
 public:
-	static std::map<std::pair<std::string, std::string>, std::string> password_lookup;
+	static const std::size_t DEFAULT_MAX_IN_FLIGHT = 16;
 
 public:
 	NetconfClient(std::string  username, std::string  password,
 			std::string  server_ip, int port, int verbosity);
+	NetconfClient(std::unique_ptr<NetconfTransport> transport, int verbosity);
 
 	~NetconfClient();
 
 	int connect();
 	std::string execute_payload(const std::string & payload);
+	// same as execute_payload, without copying the reply out of the buffer libnetconf dumped it to
+	NetconfReply execute(const std::string & payload);
+
+	// Pipelined execution: several RPCs can be in flight on the session at once.
+	// send_payload returns the message-id of the sent RPC which is used to
+	// collect its reply. Replies arriving for other message-ids are held back
+	// until they are collected.
+	std::string send_payload(const std::string & payload);
+	std::string collect_reply(const std::string & message_id);
+	NetconfReply collect(const std::string & message_id);
+	// gives up on the replies of the given rpcs, they are dropped when they arrive
+	void abandon_replies(const std::vector<std::string> & message_ids);
+	std::vector<std::string> execute_payloads(const std::vector<std::string> & payloads,
+			std::size_t max_in_flight = DEFAULT_MAX_IN_FLIGHT);
+
+	// Non-blocking counterpart of collect_reply for event-driven callers. Returns false
+	// if no complete reply is available yet; get_event_fd becomes readable when one may be.
+	bool poll_reply(std::string & message_id, std::string & reply);
+	int get_event_fd();
+
 	std::vector<std::string> get_capabilities();
 	std::string get_hostname_port();
+	bool is_connected();
+	// unlike is_connected, which only sees failures libnetconf already ran into, this
+	// exchanges a no-op rpc with the device; it also keeps idle connections from timing out
+	bool is_alive();
+	// closes the session and connects again, rpcs in flight are lost
+	void reconnect();
+
+	// Starts a notification subscription (RFC 5277) on the session, which should not be
+	// used for other rpcs afterwards. filter is a subtree filter, empty for no filter.
+	void create_subscription(const std::string & stream, const std::string & filter);
+	// waits up to timeout_ms for a notification, returns false if none arrived
+	bool receive_notification(int timeout_ms, std::string & content, time_t & event_time);
+
+	// the time spent building, sending and waiting for each rpc is recorded to stats,
+	// which has to outlive the client; nullptr turns recording off
+	void set_stats(NetconfStats * stats);
 
 private:
+	struct OutstandingRpc
+	{
+		std::string name;
+		std::size_t request_bytes;
+		std::chrono::steady_clock::time_point sent;
+	};
 
 	static void clb_print(NC_VERB_LEVEL level, const char* msg);
 	static void clb_error_print(const char* tag, const char* type,
 			const char* severity, const char* apptag, const char* path,
 			const char* message, const char* attribute, const char* element,
 			const char* ns, const char* sid);
-	static char* clb_set_password(const char* username, const char* hostname);
-	static int clb_ssh_host_authenticity_check(const char *hostname,
-			ssh_session session);
+	static void register_callbacks();
 
 	nc_rpc* build_rpc_request(const std::string & payload);
-	std::string process_rpc_reply(int reply_type, const nc_reply* reply);
+	NetconfReply process_rpc_reply(int reply_type, const nc_reply* reply);
+	NetconfReply dump_reply(const std::string & message_id, nc_reply* reply);
+	nc_reply* receive_reply(const std::string & message_id);
 	void init_capabilities();
 	void perform_session_check(std::string message);
 
 private:
 	struct nc_session *session;
 
-	std::string username;
+	std::unique_ptr<NetconfTransport> transport;
 	std::string hostname;
-	int port;
 	std::vector<std::string> capabilities;
+
+	std::map<std::string, OutstandingRpc> outstanding_rpcs;
+	std::set<std::string> abandoned_ids;
+	std::map<std::string, nc_reply*> pending_replies;
+	NetconfStats * stats;
 };
 
 
@@ -21,25 +21,85 @@
 //
 //////////////////////////////////////////////////////////////////
 
+#include <future>
 #include <iostream>
 #include <sstream>
 
 #include "errors.hpp"
 #include "netconf_client.hpp"
 #include "netconf_model_provider.hpp"
+#include "netconf_session_pool.hpp"
+#include "startup_profile.hpp"
 #include "types.hpp"
 #include "ydk_yang.hpp"
 #include <memory>
+#include <mutex>
 #include <boost/log/trivial.hpp>
 
 using namespace std;
 using namespace ydk;
+using ydk::path::ModelProvider;
+
+namespace
+{
+struct ModelSession
+{
+	mutex session_mutex;
+	unique_ptr<NetconfClient> client;
+};
+}
+
+static bool get_embedded_model(const string& name, const string& version, string & model);
+static string get_schema_payload(const string& name, const string& version, ModelProvider::Format format);
+static string get_model_from_reply(const string & reply);
 
 namespace ydk
 {
 NetconfModelProvider::NetconfModelProvider(NetconfClient & client)
-	: client(client)
+	: hostname_port(client.get_hostname_port())
+{
+	execute_payloads = [&client](const vector<string> & payloads) {
+		return client.execute_payloads(payloads);
+	};
+}
+
+NetconfModelProvider::NetconfModelProvider(NetconfSessionPool & session_pool)
+	: hostname_port(session_pool.get_hostname_port())
 {
+	// models are loaded lazily while the caller holds a pooled session, waiting for another
+	// could wait forever, so they are fetched over a session outside the pool's limit
+	auto model_session = make_shared<ModelSession>();
+	execute_payloads = [&session_pool, model_session](const vector<string> & payloads) {
+		lock_guard<mutex> lock{model_session->session_mutex};
+		if(!model_session->client)
+		{
+			model_session->client = session_pool.open_session();
+		}
+		try
+		{
+			return model_session->client->execute_payloads(payloads);
+		}
+		catch(...)
+		{
+			// the session may be dead, the next fetch opens a new one
+			model_session->client.reset();
+			throw;
+		}
+	};
+}
+
+NetconfModelProvider::NetconfModelProvider(NetconfReactor & reactor, NetconfReactor::SessionId session)
+	: hostname_port(reactor.get_hostname_port(session))
+{
+	execute_payloads = [&reactor, session](const vector<string> & payloads) {
+		vector<future<string>> replies;
+		for(auto & payload : payloads)
+			replies.push_back(reactor.submit(session, payload));
+		vector<string> results;
+		for(auto & reply : replies)
+			results.push_back(reply.get());
+		return results;
+	};
 }
 
 NetconfModelProvider::~NetconfModelProvider()
@@ -48,31 +108,67 @@ NetconfModelProvider::~NetconfModelProvider()
 
 std::string NetconfModelProvider::get_hostname_port()
 {
-	return client.get_hostname_port();
+	return hostname_port;
 }
 
 string NetconfModelProvider::get_model(const string& name, const string& version, Format format)
 {
-    string model{};
+    return get_models({{name, version}}, format).front();
+}
+
+vector<string> NetconfModelProvider::get_models(const vector<pair<string, string>>& models, Format format)
+{
+    vector<string> results(models.size());
+
+    //have to craft and send the raw payloads since the schemas might
+    //not be available
+    vector<string> payloads{};
+    vector<size_t> requested{};
+    for(size_t i = 0; i < models.size(); ++i)
+    {
+        if(get_embedded_model(models[i].first, models[i].second, results[i]))
+            continue;
+        payloads.push_back(get_schema_payload(models[i].first, models[i].second, format));
+        requested.push_back(i);
+    }
+    if(payloads.empty())
+        return results;
+
+    BOOST_LOG_TRIVIAL(debug) << "Getting " << payloads.size() << " schemas from " << hostname_port;
+    StartupPhaseTimer timer{"get-schema", payloads.size() == 1 ? models[requested.front()].first
+                                                               : std::to_string(payloads.size()) + " models"};
+    vector<string> replies = execute_payloads(payloads);
+    for(size_t i = 0; i < requested.size() && i < replies.size(); ++i)
+    {
+        BOOST_LOG_TRIVIAL(trace) << "Get schema reply " << replies[i];
+        results[requested[i]] = get_model_from_reply(replies[i]);
+        BOOST_LOG_TRIVIAL(trace) << "Model " << results[requested[i]];
+    }
+    return results;
+}
+}
 
+static bool get_embedded_model(const string& name, const string& version, string & model)
+{
     if(name == ydk::path::YDK_MODULE_NAME && version == ydk::path::YDK_MODULE_REVISION) {
-       return ydk::path::YDK_MODULE;
+       model = ydk::path::YDK_MODULE;
+       return true;
     }
 
     if(name == ydk::IETF_NETCONF_MODULE_NAME && version == ydk::IETF_NETCONF_MODULE_REVISION) {
-       return ydk::IETF_NETCONF_MODULE;
+       model = ydk::IETF_NETCONF_MODULE;
+       return true;
     }
+    return false;
+}
 
-    //have to craft and send the raw payload since the schema might
-    //not be available
-
+static string get_schema_payload(const string& name, const string& version, ModelProvider::Format format)
+{
     string file_format = "yang";
-    if(format == Format::YIN) {
+    if(format == ModelProvider::Format::YIN) {
         file_format = "yin";
     }
 
-    path::CodecService codec_service{};
-
     string payload{"<rpc xmlns=\"urn:ietf:params:xml:ns:netconf:base:1.0\">"};
     payload+= R"(<get-schema xmlns="urn:ietf:params:xml:ns:yang:ietf-netconf-monitoring">)";
     payload+="<identifier>";
@@ -90,9 +186,12 @@ string NetconfModelProvider::get_model(const string& name, const string& version
     payload+="</rpc>";
 
     BOOST_LOG_TRIVIAL(trace) << "Get schema request " << payload;
-    string reply = client.execute_payload(payload);
-    BOOST_LOG_TRIVIAL(trace) << "Get schema reply " << reply;
+    return payload;
+}
 
+static string get_model_from_reply(const string & reply)
+{
+    string model{};
 
     auto data_start = reply.find("<data ");
     if(data_start == string::npos) {
@@ -123,8 +222,5 @@ string NetconfModelProvider::get_model(const string& name, const string& version
         }
     }
 
-    BOOST_LOG_TRIVIAL(trace) << "Model " << model;
-
     return model;
 }
-}
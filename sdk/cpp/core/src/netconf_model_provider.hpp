@@ -17,26 +17,38 @@
 #ifndef _NETCONF_MODEL_PROVIDER_H_
 #define _NETCONF_MODEL_PROVIDER_H_
 
+#include <functional>
 #include <memory>
 #include <string>
+#include <utility>
+#include <vector>
 
+#include "netconf_reactor.hpp"
 #include "path_api.hpp"
 
 namespace ydk {
 
 class NetconfClient;
+class NetconfSessionPool;
 
 class NetconfModelProvider : public path::ModelProvider {
 public:
 		NetconfModelProvider(NetconfClient & client);
+		// models are fetched over a session of their own, opened on first use outside the
+		// pool's limit, as they may be loaded while the pool is exhausted
+		NetconfModelProvider(NetconfSessionPool & session_pool);
+		NetconfModelProvider(NetconfReactor & reactor, NetconfReactor::SessionId session);
 
         ~NetconfModelProvider();
 
         std::string get_model(const std::string& name, const std::string& version, Format format);
+        // the get-schema requests are pipelined on one session
+        std::vector<std::string> get_models(const std::vector<std::pair<std::string, std::string>>& models, Format format);
         std::string get_hostname_port();
 
 private:
-        NetconfClient & client;
+        std::function<std::vector<std::string>(const std::vector<std::string> &)> execute_payloads;
+        std::string hostname_port;
 };
 }
 
@@ -0,0 +1,295 @@
+/// YANG Development Kit
+// Copyright 2016 Cisco Systems. All rights reserved
+//
+////////////////////////////////////////////////////////////////
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+//
+//////////////////////////////////////////////////////////////////
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <boost/log/trivial.hpp>
+
+#include "netconf_client.hpp"
+#include "netconf_notification.hpp"
+
+using namespace std;
+
+namespace ydk
+{
+// the receiver thread checks this often whether it has to stop
+static const int RECEIVE_TIMEOUT_MS = 100;
+
+// Bounded ring buffer for exactly one producer and one consumer thread. One slot is kept
+// free to tell a full buffer from an empty one.
+template<typename T>
+class SpscQueue
+{
+public:
+	explicit SpscQueue(size_t capacity)
+		: slots(capacity + 1), head(0), tail(0)
+	{
+	}
+
+	bool push(T && value)
+	{
+		size_t current = tail.load(memory_order_relaxed);
+		size_t next = (current + 1) % slots.size();
+		if(next == head.load(memory_order_acquire))
+		{
+			return false;
+		}
+		slots[current] = move(value);
+		tail.store(next, memory_order_release);
+		return true;
+	}
+
+	bool pop(T & value)
+	{
+		size_t current = head.load(memory_order_relaxed);
+		if(current == tail.load(memory_order_acquire))
+		{
+			return false;
+		}
+		value = move(slots[current]);
+		head.store((current + 1) % slots.size(), memory_order_release);
+		return true;
+	}
+
+private:
+	vector<T> slots;
+	atomic<size_t> head;
+	atomic<size_t> tail;
+};
+
+class NetconfSubscription::Receiver
+{
+public:
+	Receiver(unique_ptr<NetconfClient> client, const path::RootSchemaNode * root_schema,
+			const NetconfSubscriptionOptions & options, Callback callback);
+	~Receiver();
+
+	bool try_pop(NetconfNotification & notification);
+	bool pop(NetconfNotification & notification, chrono::milliseconds timeout);
+	void stop();
+
+	atomic<bool> active;
+	atomic<size_t> dropped;
+
+private:
+	void run();
+	void receive();
+	void deliver(NetconfNotification notification);
+
+private:
+	unique_ptr<NetconfClient> client;
+	const path::RootSchemaNode * root_schema;
+	Callback callback;
+	SpscQueue<NetconfNotification> queue;
+
+	atomic<bool> stopping;
+	// the queue is lock free, the mutex only serves to sleep in pop until a push
+	mutex wakeup_mutex;
+	condition_variable wakeup;
+	atomic<bool> consumer_waiting;
+
+	thread receiver_thread;
+};
+
+NetconfSubscription::Receiver::Receiver(unique_ptr<NetconfClient> client, const path::RootSchemaNode * root_schema,
+		const NetconfSubscriptionOptions & options, Callback callback)
+	: active(true), dropped(0), client(move(client)), root_schema(root_schema), callback(callback),
+	  queue(max<size_t>(options.queue_size, 1)), stopping(false), consumer_waiting(false)
+{
+	this->client->create_subscription(options.stream, options.filter);
+	receiver_thread = thread{&Receiver::run, this};
+}
+
+NetconfSubscription::Receiver::~Receiver()
+{
+	stop();
+}
+
+void NetconfSubscription::Receiver::stop()
+{
+	stopping = true;
+	if(receiver_thread.joinable())
+	{
+		receiver_thread.join();
+	}
+	active = false;
+	{
+		lock_guard<mutex> lock{wakeup_mutex};
+	}
+	wakeup.notify_all();
+}
+
+void NetconfSubscription::Receiver::run()
+{
+	// an exception leaving the thread would terminate the process, any other than those
+	// of the session and of decoding ends the subscription instead
+	try
+	{
+		receive();
+	}
+	catch(const exception & e)
+	{
+		BOOST_LOG_TRIVIAL(error) << "Notification subscription to " << client->get_hostname_port() << " failed: " << e.what();
+	}
+	catch(...)
+	{
+		BOOST_LOG_TRIVIAL(error) << "Notification subscription to " << client->get_hostname_port() << " failed with an unknown error";
+	}
+
+	active = false;
+	{
+		lock_guard<mutex> lock{wakeup_mutex};
+	}
+	wakeup.notify_all();
+}
+
+void NetconfSubscription::Receiver::receive()
+{
+	path::CodecService codec_service{};
+	while(!stopping)
+	{
+		NetconfNotification notification{};
+		time_t event_time = 0;
+		try
+		{
+			if(!client->receive_notification(RECEIVE_TIMEOUT_MS, notification.payload, event_time))
+			{
+				continue;
+			}
+		}
+		catch(YCPPError & e)
+		{
+			BOOST_LOG_TRIVIAL(error) << "Notification subscription to " << client->get_hostname_port() << " ended: " << e.err_msg;
+			return;
+		}
+
+		notification.event_time = chrono::system_clock::from_time_t(event_time);
+		try
+		{
+			notification.data.reset(codec_service.decode_notification(root_schema, notification.payload.c_str(),
+					path::CodecService::Format::XML));
+		}
+		catch(YCPPError & e)
+		{
+			BOOST_LOG_TRIVIAL(debug) << "Could not decode notification: " << notification.payload;
+		}
+		deliver(move(notification));
+	}
+}
+
+void NetconfSubscription::Receiver::deliver(NetconfNotification notification)
+{
+	if(callback)
+	{
+		try
+		{
+			callback(move(notification));
+		}
+		catch(...)
+		{
+			BOOST_LOG_TRIVIAL(error) << "Notification callback threw an exception";
+		}
+		return;
+	}
+
+	if(!queue.push(move(notification)))
+	{
+		++dropped;
+		return;
+	}
+
+	// pairs with the fence in pop, so that either the consumer sees the notification
+	// or the producer sees the consumer waiting
+	atomic_thread_fence(memory_order_seq_cst);
+	if(consumer_waiting.load(memory_order_relaxed))
+	{
+		{
+			lock_guard<mutex> lock{wakeup_mutex};
+		}
+		wakeup.notify_one();
+	}
+}
+
+bool NetconfSubscription::Receiver::try_pop(NetconfNotification & notification)
+{
+	return queue.pop(notification);
+}
+
+bool NetconfSubscription::Receiver::pop(NetconfNotification & notification, chrono::milliseconds timeout)
+{
+	if(queue.pop(notification))
+	{
+		return true;
+	}
+
+	unique_lock<mutex> lock{wakeup_mutex};
+	consumer_waiting.store(true, memory_order_relaxed);
+	atomic_thread_fence(memory_order_seq_cst);
+	bool popped = false;
+	wakeup.wait_for(lock, timeout, [this, &notification, &popped]() {
+		popped = queue.pop(notification);
+		return popped || !active;
+	});
+	consumer_waiting.store(false, memory_order_relaxed);
+	return popped;
+}
+
+NetconfSubscription::NetconfSubscription(unique_ptr<NetconfClient> client, const path::RootSchemaNode * root_schema,
+		const NetconfSubscriptionOptions & options, Callback callback)
+	: receiver(new Receiver{move(client), root_schema, options, callback})
+{
+}
+
+NetconfSubscription::~NetconfSubscription()
+{
+}
+
+bool NetconfSubscription::try_pop(NetconfNotification & notification)
+{
+	return receiver->try_pop(notification);
+}
+
+bool NetconfSubscription::pop(NetconfNotification & notification, chrono::milliseconds timeout)
+{
+	return receiver->pop(notification, timeout);
+}
+
+bool NetconfSubscription::is_active() const
+{
+	return receiver->active;
+}
+
+size_t NetconfSubscription::get_dropped() const
+{
+	return receiver->dropped;
+}
+
+void NetconfSubscription::close()
+{
+	receiver->stop();
+}
+}
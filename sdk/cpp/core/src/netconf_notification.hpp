@@ -0,0 +1,86 @@
+/*  ----------------------------------------------------------------
+ Copyright 2016 Cisco Systems
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+------------------------------------------------------------------*/
+
+#ifndef _NETCONF_NOTIFICATION_H_
+#define _NETCONF_NOTIFICATION_H_
+
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <string>
+
+#include "path_api.hpp"
+
+namespace ydk {
+
+class NetconfClient;
+
+struct NetconfNotification
+{
+	std::chrono::system_clock::time_point event_time;
+	// the notification element as received, without its eventTime
+	std::string payload;
+	// the decoded notification, nullptr if it is not modelled in the provider's schema
+	std::unique_ptr<path::DataNode> data;
+};
+
+struct NetconfSubscriptionOptions
+{
+	// event stream to subscribe to
+	std::string stream = "NETCONF";
+	// subtree filter selecting the notifications, empty for all of them
+	std::string filter;
+	// notifications arriving while this many are waiting to be popped are dropped
+	std::size_t queue_size = 1024;
+};
+
+// A notification subscription running on a session of its own. A receiver thread reads
+// the notifications, decodes them and either hands them to a callback or queues them on a
+// bounded single producer, single consumer lock-free queue for pop/try_pop. Queued
+// notifications must be popped from one thread at a time.
+//
+// The provider which created the subscription has to outlive it.
+class NetconfSubscription
+{
+public:
+	typedef std::function<void(NetconfNotification notification)> Callback;
+
+public:
+	NetconfSubscription(std::unique_ptr<NetconfClient> client, const path::RootSchemaNode * root_schema,
+			const NetconfSubscriptionOptions & options, Callback callback = nullptr);
+	~NetconfSubscription();
+
+	NetconfSubscription(const NetconfSubscription&) = delete;
+	NetconfSubscription& operator=(const NetconfSubscription&) = delete;
+
+	bool try_pop(NetconfNotification & notification);
+	// waits up to timeout for a notification, returns false if none arrived
+	bool pop(NetconfNotification & notification, std::chrono::milliseconds timeout);
+
+	// false once the session has failed or the subscription was closed
+	bool is_active() const;
+	// notifications dropped because the queue was full
+	std::size_t get_dropped() const;
+	void close();
+
+private:
+	class Receiver;
+
+	std::unique_ptr<Receiver> receiver;
+};
+}
+
+#endif /*_NETCONF_NOTIFICATION_H_*/
@@ -27,11 +27,16 @@
 #include "types.hpp"
 #include "netconf_client.hpp"
 #include "netconf_provider.hpp"
+#include "netconf_session_pool.hpp"
 #include "netconf_model_provider.hpp"
 #include "entity_data_node_walker.hpp"
+#include "path/path_private.hpp"
 #include "errors.hpp"
 #include "ydk_yang.hpp"
+#include <deque>
+#include <future>
 #include <memory>
+#include <mutex>
 #include <boost/log/trivial.hpp>
 #include <libyang/libyang.h>
 
@@ -50,38 +55,126 @@ static bool is_candidate_supported(vector<string> capbilities);
 static void create_input_target(path::DataNode & input, bool candidate_supported);
 static void create_input_source(path::DataNode & input, bool config);
 static void create_input_error_option(path::DataNode & input);
+static vector<path::DataNode*> get_config(path::RootSchemaNode* root_schema, path::Rpc & rpc, unique_ptr<const path::DataNode> & decoded);
+static string get_annotated_xml(path::RootSchemaNode & root_schema, path::DataNode & element, const path::Annotation & annotation, bool owned);
+static string get_operation(path::DataNode & node);
+static bool is_leaf_data_node(path::DataNode & node);
+static bool can_merge_data_node(path::DataNode & target, path::DataNode & source);
+static void merge_data_node(path::DataNode & target, path::DataNode & source);
+static path::DataNode* copy_data_node(path::RootSchemaNode & root_schema, path::DataNode & data, unique_ptr<const path::DataNode> & root);
 static string get_annotated_config_payload(path::RootSchemaNode* root_schema, path::Rpc & rpc, path::Annotation & annotation);
+static string get_edit_config_payload(path::RootSchemaNode & root_schema, bool candidate_supported, const string & config_payload);
 static string get_commit_rpc_payload();
-static path::DataNode* handle_edit_reply(string reply, NetconfClient & client, bool candidate_supported);
-
+static string get_confirmed_commit_rpc_payload(chrono::seconds confirm_timeout);
+static string get_datastore_rpc_payload(const string & operation, bool candidate_supported);
+static string get_operation_rpc_payload(const string & operation);
+static void check_ok_reply(NetconfReply & reply);
+static path::DataNode* handle_edit_reply(NetconfReply & reply, const function<NetconfReply(const string &)> & execute, bool candidate_supported);
 static string get_read_rpc_name(bool config);
 static bool is_config(path::Rpc & rpc);
 static string get_filter_payload(path::Rpc & ydk_rpc);
 static string get_netconf_payload(path::DataNode* input, string data_tag, string data_value);
-static path::DataNode* handle_read_reply(string reply, path::RootSchemaNode * root_schema);
+static path::DataNode* handle_read_reply(NetconfReply & reply, path::RootSchemaNode * root_schema);
+static void add_read_reply(NetconfReply & reply, path::StreamingDecoder & decoder);
+static void execute_pipelined(NetconfClient & session, const vector<string> & payloads,
+                              const function<void(NetconfReply &)> & on_reply);
+
+struct FilterElement
+{
+	string start_tag;
+	string name;
+	size_t begin;
+	size_t end;
+	vector<pair<size_t, size_t>> children;
+};
+static vector<string> split_filter(path::RootSchemaNode & root_schema, const string & filter);
+static vector<FilterElement> scan_filter(const string & filter);
+static vector<string> split_filter_element(path::RootSchemaNode & root_schema, const string & filter,
+		const FilterElement & element);
+static const struct lys_node* find_top_node(path::RootSchemaNode & root_schema, const FilterElement & element);
+static const struct lys_node* find_child_node(const struct lys_node* parent, const string & name);
+static bool is_content_match_node(const string & element);
+static string get_tag_name(const string & tag);
+static string get_default_namespace(const string & tag);
 
 const char* CANDIDATE = "urn:ietf:params:netconf:capability:candidate:1.0";
+const char* CONFIRMED_COMMIT = "urn:ietf:params:netconf:capability:confirmed-commit:1.0";
+const char* CONFIRMED_COMMIT_1_1 = "urn:ietf:params:netconf:capability:confirmed-commit:1.1";
 
 NetconfServiceProvider::NetconfServiceProvider(string address, string username, string password, int port)
-    : m_repo_ptr(make_unique<path::Repository>()), m_repo{*m_repo_ptr}, client(make_unique<NetconfClient>(username, password, address, port, 0)),
-	  model_provider(make_unique<NetconfModelProvider>(*client))
+    : NetconfServiceProvider(address, username, password, port, NetconfSessionPoolOptions{})
+{
+}
+
+NetconfServiceProvider::NetconfServiceProvider(path::Repository & repo, string address, string username, string password, int port)
+    : NetconfServiceProvider(repo, address, username, password, port, NetconfSessionPoolOptions{})
+{
+}
+
+NetconfServiceProvider::NetconfServiceProvider(string address, string username, string password, int port,
+                                               const NetconfSessionPoolOptions & pool_options)
+    : m_repo_ptr(make_unique<path::Repository>()), m_repo{*m_repo_ptr},
+      session_pool(make_unique<NetconfSessionPool>(username, password, address, port, pool_options)),
+      reactor(nullptr), reactor_session(0),
+	  model_provider(make_unique<NetconfModelProvider>(*session_pool))
 {
     initialize();
     BOOST_LOG_TRIVIAL(debug) << "Connected to " << address << " on port "<< port <<" using ssh";
 }
 
-NetconfServiceProvider::NetconfServiceProvider(path::Repository & repo, string address, string username, string password, int port)
-    : m_repo_ptr(nullptr),m_repo{repo}, client(make_unique<NetconfClient>(username, password, address, port, 0)),
-	  model_provider(make_unique<NetconfModelProvider>(*client))
+NetconfServiceProvider::NetconfServiceProvider(path::Repository & repo, string address, string username, string password, int port,
+                                               const NetconfSessionPoolOptions & pool_options)
+    : m_repo_ptr(nullptr),m_repo{repo},
+      session_pool(make_unique<NetconfSessionPool>(username, password, address, port, pool_options)),
+      reactor(nullptr), reactor_session(0),
+	  model_provider(make_unique<NetconfModelProvider>(*session_pool))
 {
     initialize();
     BOOST_LOG_TRIVIAL(debug) << "Connected to " << address << " on port "<< port <<" using ssh";
 }
 
+NetconfServiceProvider::NetconfServiceProvider(path::Repository & repo, const NetconfTransport & transport,
+                                               const NetconfSessionPoolOptions & pool_options)
+    : m_repo_ptr(nullptr),m_repo{repo},
+      session_pool(make_unique<NetconfSessionPool>(transport, pool_options)),
+      reactor(nullptr), reactor_session(0),
+	  model_provider(make_unique<NetconfModelProvider>(*session_pool))
+{
+    initialize();
+    BOOST_LOG_TRIVIAL(debug) << "Connected to " << transport.get_hostname_port();
+}
+
+NetconfServiceProvider::NetconfServiceProvider(const NetconfTransport & transport,
+                                               const NetconfSessionPoolOptions & pool_options)
+    : m_repo_ptr(make_unique<path::Repository>()), m_repo{*m_repo_ptr},
+      session_pool(make_unique<NetconfSessionPool>(transport, pool_options)),
+      reactor(nullptr), reactor_session(0),
+	  model_provider(make_unique<NetconfModelProvider>(*session_pool))
+{
+    initialize();
+    BOOST_LOG_TRIVIAL(debug) << "Connected to " << transport.get_hostname_port();
+}
+
+NetconfServiceProvider::NetconfServiceProvider(NetconfReactor & reactor, path::Repository & repo,
+                                               string address, string username, string password, int port)
+    : m_repo_ptr(nullptr),m_repo{repo}, session_pool(nullptr),
+      reactor(&reactor), reactor_session(reactor.connect(username, password, address, port, &stats)),
+	  model_provider(make_unique<NetconfModelProvider>(reactor, reactor_session))
+{
+    initialize();
+    BOOST_LOG_TRIVIAL(debug) << "Connected to " << address << " on port "<< port <<" using ssh, driven by reactor";
+}
+
 void NetconfServiceProvider::initialize()
 {
-	client->connect();
-	server_capabilities = client->get_capabilities();
+	if(reactor)
+	{
+		server_capabilities = reactor->get_capabilities(reactor_session);
+	}
+	else
+	{
+		server_capabilities = session_pool->get_capabilities();
+	}
 
 	for(std::string c : server_capabilities )
 	{
@@ -92,12 +185,14 @@ void NetconfServiceProvider::initialize()
 		}
 	}
 
-	root_schema = std::unique_ptr<ydk::path::RootSchemaNode>(
-								m_repo.create_root_schema
-									(
-									get_core_capabilities(server_capabilities)
-									)
-								);
+	std::vector<path::Capability> core_capabilities{};
+	{
+		StartupPhaseTimer timer{"get-core-capabilities"};
+		core_capabilities = get_core_capabilities(server_capabilities);
+	}
+	// devices announcing the same capabilities share one schema
+	root_schema = m_repo.get_shared_root_schema(core_capabilities);
+	startup_scope.end();
 
 	if(root_schema.get() == nullptr)
 	{
@@ -112,11 +207,18 @@ NetconfServiceProvider::~NetconfServiceProvider()
 	if(ietf_nc_monitoring_available){
 		m_repo.remove_model_provider(model_provider.get());
 	}
+	if(reactor){
+		reactor->disconnect(reactor_session);
+	}
 }
 
 std::string NetconfServiceProvider::execute_payload(std::string payload)
 {
-       std::string reply = client->execute_payload(payload);
+    std::string reply{};
+    on_session([&](const PayloadExecutor & execute) -> path::DataNode* {
+        reply = execute(payload).str();
+        return nullptr;
+    });
     BOOST_LOG_TRIVIAL(debug) <<"=============Reply payload=============";
     BOOST_LOG_TRIVIAL(debug) << reply;
     BOOST_LOG_TRIVIAL(debug) <<"=========================="<<endl;
@@ -130,8 +232,205 @@ path::RootSchemaNode* NetconfServiceProvider::get_root_schema() const 	//current
     return root_schema.get();
 }
 
+path::DataNode* NetconfServiceProvider::on_session(std::function<path::DataNode*(const PayloadExecutor &)> operation,
+                                                   bool idempotent) const
+{
+    if(reactor)
+    {
+        return operation([this](const string & payload) {
+            return NetconfReply{reactor->execute_payload(reactor_session, payload)};
+        });
+    }
+
+    return on_pooled_session([&operation](NetconfClient & session) {
+        return operation([&session](const string & payload) {
+            return session.execute(payload);
+        });
+    }, idempotent);
+}
+
+path::DataNode* NetconfServiceProvider::on_pipelined_session(std::function<path::DataNode*(const PipelineExecutor &)> operation,
+                                                             bool idempotent) const
+{
+    if(reactor)
+    {
+        return operation([this](const vector<string> & payloads, const function<void(NetconfReply &)> & on_reply) {
+            vector<future<string>> replies;
+            for(auto & payload : payloads)
+            {
+                replies.push_back(reactor->submit(reactor_session, payload));
+            }
+            for(auto & reply : replies)
+            {
+                NetconfReply netconf_reply{reply.get()};
+                on_reply(netconf_reply);
+            }
+        });
+    }
+
+    return on_pooled_session([&operation](NetconfClient & session) {
+        return operation([&session](const vector<string> & payloads, const function<void(NetconfReply &)> & on_reply) {
+            execute_pipelined(session, payloads, on_reply);
+        });
+    }, idempotent);
+}
+
+path::DataNode* NetconfServiceProvider::on_pooled_session(std::function<path::DataNode*(NetconfClient &)> operation,
+                                                          bool idempotent) const
+{
+    for(int attempt = 0; ; ++attempt)
+    {
+        auto session = session_pool->checkout();
+        session->set_stats(&stats);
+        try
+        {
+            return operation(*session);
+        }
+        catch(YCPPClientError & e)
+        {
+            // the dead session is discarded when it goes back to the pool
+            if(!idempotent || attempt > 0 || session->is_connected())
+            {
+                throw;
+            }
+            BOOST_LOG_TRIVIAL(debug) << "Session to " << session_pool->get_hostname_port() << " dropped, retrying on a new session";
+        }
+    }
+}
+
+void NetconfServiceProvider::set_read_mode(ReadMode mode)
+{
+    read_mode = mode;
+}
+
+ReadMode NetconfServiceProvider::get_read_mode() const
+{
+    return read_mode;
+}
+
+NetconfStats & NetconfServiceProvider::get_stats() const
+{
+    return stats;
+}
+
+// the entity to edit is encoded straight from the trees attached to it, see get_config
+bool NetconfServiceProvider::supports_attached_data(const std::string & name) const
+{
+    return name == "entity";
+}
+
+void NetconfServiceProvider::record_read_populate(bool config, chrono::steady_clock::duration elapsed) const
+{
+    stats.record(get_read_rpc_name(config), RpcPhase::populate, elapsed);
+}
+
+const StartupProfile & NetconfServiceProvider::get_startup_profile() const
+{
+    return startup_profile;
+}
+
+void NetconfServiceProvider::keepalive()
+{
+    if(reactor)
+    {
+        return;
+    }
+    session_pool->evict_idle();
+    session_pool->keepalive();
+}
+
+unique_ptr<NetconfTransaction> NetconfServiceProvider::begin_transaction(const NetconfTransactionOptions & options)
+{
+    if(reactor)
+    {
+        BOOST_LOG_TRIVIAL(error) << "Transactions are not supported on reactor driven sessions";
+        BOOST_THROW_EXCEPTION(YCPPOperationNotSupportedError{"Transactions are not supported on reactor driven sessions"});
+    }
+    return make_unique<NetconfTransaction>(*this, options);
+}
+
+unique_ptr<NetconfSubscription> NetconfServiceProvider::subscribe(const NetconfSubscriptionOptions & options)
+{
+    return subscribe(options, nullptr);
+}
+
+unique_ptr<NetconfSubscription> NetconfServiceProvider::subscribe(const NetconfSubscriptionOptions & options,
+                                                                  NetconfSubscription::Callback callback)
+{
+    if(reactor)
+    {
+        BOOST_LOG_TRIVIAL(error) << "Notification subscriptions are not supported on reactor driven sessions";
+        BOOST_THROW_EXCEPTION(YCPPOperationNotSupportedError{"Notification subscriptions are not supported on reactor driven sessions"});
+    }
+    // the subscription takes over its session for good, so it does not come from the pool
+    return make_unique<NetconfSubscription>(session_pool->open_session(), root_schema.get(), options, callback);
+}
+
+static void execute_pipelined(NetconfClient & session, const vector<string> & payloads,
+                              const function<void(NetconfReply &)> & on_reply)
+{
+    deque<string> in_flight;
+    size_t next = 0;
+    try
+    {
+        while(next < payloads.size() || !in_flight.empty())
+        {
+            while(next < payloads.size() && in_flight.size() < NetconfClient::DEFAULT_MAX_IN_FLIGHT)
+            {
+                in_flight.push_back(session.send_payload(payloads[next++]));
+            }
+            NetconfReply reply = session.collect(in_flight.front());
+            in_flight.pop_front();
+            on_reply(reply);
+        }
+    }
+    catch(...)
+    {
+        session.abandon_replies({in_flight.begin(), in_flight.end()});
+        throw;
+    }
+}
+
+path::DataNode* NetconfServiceProvider::handle_streaming_read(path::Rpc* ydk_rpc) const
+{
+    bool config = is_config(*ydk_rpc);
+    std::string filter_value = get_filter_payload(*ydk_rpc);
+
+    vector<string> payloads;
+    for(auto & filter : split_filter(*root_schema, filter_value))
+    {
+        auto netconf_rpc = create_rpc_instance(*root_schema, get_read_rpc_name(config));
+        auto input = create_rpc_input(*netconf_rpc);
+        create_input_source(*input, config);
+        payloads.push_back(get_netconf_payload(input, "filter", filter));
+    }
+    if(payloads.empty())
+    {
+        BOOST_LOG_TRIVIAL(debug) << "Filter has no subtree to read";
+        return nullptr;
+    }
+    BOOST_LOG_TRIVIAL(debug) << "Reading " << payloads.size() << " filter subtree(s) with pipelined rpcs";
+
+    string rpc_name = get_rpc_name(payloads.front());
+    return on_pipelined_session([&](const PipelineExecutor & execute) {
+        // a retry on a new session starts over with the replies
+        path::StreamingDecoder decoder{root_schema.get(), path::CodecService::Format::XML};
+        execute(payloads, [this, &decoder, &rpc_name](NetconfReply & reply) {
+            RpcPhaseTimer timer{&stats, rpc_name, RpcPhase::decode};
+            timer.set_bytes(0, reply.size());
+            add_read_reply(reply, decoder);
+        });
+        return decoder.finish();
+    }, true);
+}
+
 path::DataNode* NetconfServiceProvider::handle_read(path::Rpc* ydk_rpc) const
 {
+    if(read_mode == ReadMode::streaming)
+    {
+        return handle_streaming_read(ydk_rpc);
+    }
+
     //for now we only support crud rpc's
     bool config = is_config(*ydk_rpc);
     auto netconf_rpc = create_rpc_instance(*root_schema, get_read_rpc_name(config));
@@ -141,11 +440,15 @@ path::DataNode* NetconfServiceProvider::handle_read(path::Rpc* ydk_rpc) const
 
     string netconf_payload = get_netconf_payload(input, "filter", filter_value);
 
-    std::string reply = client->execute_payload(netconf_payload);
-    BOOST_LOG_TRIVIAL(debug) <<"=============Reply payload=============";
-    BOOST_LOG_TRIVIAL(debug) << reply;
-    BOOST_LOG_TRIVIAL(debug) << endl;
-    return handle_read_reply(reply, root_schema.get());
+    return on_session([&](const PayloadExecutor & execute) {
+        NetconfReply reply = execute(netconf_payload);
+        BOOST_LOG_TRIVIAL(debug) <<"=============Reply payload=============";
+        BOOST_LOG_TRIVIAL(debug) << reply.c_str();
+        BOOST_LOG_TRIVIAL(debug) << endl;
+        RpcPhaseTimer timer{&stats, get_rpc_name(netconf_payload), RpcPhase::decode};
+        timer.set_bytes(netconf_payload.size(), reply.size());
+        return handle_read_reply(reply, root_schema.get());
+    }, true);
 }
 
 path::DataNode* NetconfServiceProvider::handle_edit(path::Rpc* ydk_rpc, path::Annotation annotation) const
@@ -153,21 +456,17 @@ path::DataNode* NetconfServiceProvider::handle_edit(path::Rpc* ydk_rpc, path::An
     //for now we only support crud rpc's
     bool candidate_supported = is_candidate_supported(server_capabilities);
 
-    auto netconf_rpc = create_rpc_instance(*root_schema, "ietf-netconf:edit-config");
-    auto input = create_rpc_input(*netconf_rpc);
-    create_input_target(*input, candidate_supported);
-    create_input_error_option(*input);
     string config_payload = get_annotated_config_payload(root_schema.get(), *ydk_rpc, annotation);
-
-    ly_verb(LY_LLSILENT); //turn off libyang logging at the beginning
-    string netconf_payload = get_netconf_payload(input, "config", config_payload);
-    ly_verb(LY_LLVRB); // enable libyang logging after payload has been created
-
-    std::string reply = client->execute_payload(netconf_payload);
-    BOOST_LOG_TRIVIAL(debug) <<"=============Reply payload=============";
-    BOOST_LOG_TRIVIAL(debug) << reply;
-    BOOST_LOG_TRIVIAL(debug) << endl;
-    return handle_edit_reply(reply, *client, candidate_supported);
+    string netconf_payload = get_edit_config_payload(*root_schema, candidate_supported, config_payload);
+
+    // edit and commit must go out on the same session
+    return on_session([&](const PayloadExecutor & execute) {
+        NetconfReply reply = execute(netconf_payload);
+        BOOST_LOG_TRIVIAL(debug) <<"=============Reply payload=============";
+        BOOST_LOG_TRIVIAL(debug) << reply.c_str();
+        BOOST_LOG_TRIVIAL(debug) << endl;
+        return handle_edit_reply(reply, execute, candidate_supported);
+    });
 }
 
 path::DataNode* NetconfServiceProvider::invoke(path::Rpc* rpc) const
@@ -208,6 +507,318 @@ path::DataNode* NetconfServiceProvider::invoke(path::Rpc* rpc) const
     return datanode;
 }
 
+// The top level elements queued by a transaction, the edits to an element merged into one
+// tree. An element only appears again when an edit could not be merged into it. The queue
+// holds copies of the elements, the trees given to invoke() may be gone by the commit.
+struct NetconfTransaction::EditQueue
+{
+    struct Element
+    {
+        string path;
+        // the root owning data
+        unique_ptr<const path::DataNode> root;
+        path::DataNode* data;
+    };
+
+    void add(path::RootSchemaNode & root_schema, path::DataNode & data, const path::Annotation & annotation);
+    void clear();
+    vector<string> get_edit_configs(size_t max_edit_bytes);
+
+    mutex queue_mutex;
+    vector<Element> elements;
+};
+
+void NetconfTransaction::EditQueue::add(path::RootSchemaNode & root_schema, path::DataNode & data, const path::Annotation & annotation)
+{
+    Element element{};
+    data.append_segment(element.path);
+    element.data = copy_data_node(root_schema, data, element.root);
+    if(element.data->annotations().empty())
+    {
+        element.data->add_annotation(annotation);
+    }
+    string operation = get_operation(*element.data);
+
+    lock_guard<mutex> lock{queue_mutex};
+    auto queued = find_if(elements.rbegin(), elements.rend(), [&element](const Element & other) {
+        return other.path == element.path;
+    });
+    if(queued == elements.rend())
+    {
+        elements.push_back(move(element));
+        return;
+    }
+
+    string queued_operation = get_operation(*queued->data);
+    if((queued_operation == "delete" || queued_operation == "remove") && (operation == "merge" || operation == "replace"))
+    {
+        // the element is deleted and written again, which is replacing it
+        path::DataNode* replaced = root_schema.create(element.path);
+        queued->root.reset(replaced->root());
+        replaced->add_annotation({IETF_NETCONF_MODULE_NAME, "operation", "replace"});
+        merge_data_node(*replaced, *element.data);
+        queued->data = replaced;
+    }
+    else if((queued_operation == "merge" || queued_operation == "replace") && operation == "merge"
+            && can_merge_data_node(*queued->data, *element.data))
+    {
+        merge_data_node(*queued->data, *element.data);
+    }
+    else
+    {
+        elements.push_back(move(element));
+    }
+}
+
+void NetconfTransaction::EditQueue::clear()
+{
+    lock_guard<mutex> lock{queue_mutex};
+    elements.clear();
+}
+
+// an element already in an edit-config starts the next one, as servers do not agree on how
+// to apply repeated top level elements within one <config>
+vector<string> NetconfTransaction::EditQueue::get_edit_configs(size_t max_edit_bytes)
+{
+    path::CodecService codec_service{};
+    vector<string> configs;
+    vector<string> paths;
+    lock_guard<mutex> lock{queue_mutex};
+    for(auto & element : elements)
+    {
+        string config = codec_service.encode(element.data, path::CodecService::Format::XML, true);
+        bool repeated = find(paths.begin(), paths.end(), element.path) != paths.end();
+        if(configs.empty() || repeated || configs.back().size() + config.size() > max_edit_bytes)
+        {
+            configs.emplace_back();
+            paths.clear();
+        }
+        configs.back() += config;
+        paths.push_back(element.path);
+    }
+    return configs;
+}
+
+NetconfTransaction::NetconfTransaction(const NetconfServiceProvider & provider, const NetconfTransactionOptions & options)
+    : provider(provider), options(options),
+      candidate_supported(is_candidate_supported(provider.server_capabilities)), state(State::open),
+      locked(false), queue(make_unique<EditQueue>())
+{
+    // without the candidate the edits would go straight to running, with nothing to confirm or roll back
+    auto & capabilities = provider.server_capabilities;
+    if(options.confirmed && !candidate_supported)
+    {
+        BOOST_LOG_TRIVIAL(error) << "Confirmed commit needs the candidate datastore, which is not supported by " << provider.session_pool->get_hostname_port();
+        BOOST_THROW_EXCEPTION(YCPPOperationNotSupportedError{"Confirmed commit needs the candidate datastore, which is not supported by the device"});
+    }
+    if(options.confirmed
+       && find(capabilities.begin(), capabilities.end(), CONFIRMED_COMMIT) == capabilities.end()
+       && find(capabilities.begin(), capabilities.end(), CONFIRMED_COMMIT_1_1) == capabilities.end())
+    {
+        BOOST_LOG_TRIVIAL(error) << "Confirmed commit is not supported by " << provider.session_pool->get_hostname_port();
+        BOOST_THROW_EXCEPTION(YCPPOperationNotSupportedError{"Confirmed commit is not supported by the device"});
+    }
+}
+
+NetconfTransaction::~NetconfTransaction()
+{
+    try
+    {
+        rollback();
+    }
+    catch(YCPPError & e)
+    {
+        BOOST_LOG_TRIVIAL(error) << "Failed to roll back transaction: " << e.err_msg;
+    }
+    catch(...)
+    {
+        BOOST_LOG_TRIVIAL(error) << "Failed to roll back transaction";
+    }
+}
+
+path::RootSchemaNode* NetconfTransaction::get_root_schema() const
+{
+    return provider.get_root_schema();
+}
+
+bool NetconfTransaction::supports_attached_data(const std::string & name) const
+{
+    return provider.supports_attached_data(name);
+}
+
+path::DataNode* NetconfTransaction::invoke(path::Rpc* rpc) const
+{
+    path::RootSchemaNode & root_schema = *provider.root_schema;
+    if(rpc == nullptr)
+    {
+        BOOST_LOG_TRIVIAL(error) << "rpc is nullptr";
+        BOOST_THROW_EXCEPTION(YCPPInvalidArgumentError{"rpc is null!"});
+    }
+
+    path::SchemaNode* rpc_schema = rpc->schema();
+    path::SchemaNode* delete_schema = get_schema_for_operation(root_schema, "ydk:delete");
+    if(rpc_schema != get_schema_for_operation(root_schema, "ydk:create")
+       && rpc_schema != get_schema_for_operation(root_schema, "ydk:update")
+       && rpc_schema != delete_schema)
+    {
+        BOOST_LOG_TRIVIAL(error) << "Only edits can be part of a transaction";
+        BOOST_THROW_EXCEPTION(YCPPOperationNotSupportedError{"Only edits can be part of a transaction"});
+    }
+    if(state != State::open)
+    {
+        BOOST_LOG_TRIVIAL(error) << "Transaction has ended";
+        BOOST_THROW_EXCEPTION(YCPPIllegalStateError{"Transaction has ended"});
+    }
+
+    path::Annotation annotation{IETF_NETCONF_MODULE_NAME, "operation", rpc_schema == delete_schema ? "delete" : "merge"};
+    unique_ptr<const path::DataNode> decoded;
+    for(auto element : get_config(&root_schema, *rpc, decoded))
+    {
+        queue->add(root_schema, *element, annotation);
+    }
+    return nullptr;
+}
+
+void NetconfTransaction::commit()
+{
+    if(state != State::open)
+    {
+        BOOST_LOG_TRIVIAL(error) << "Transaction has ended";
+        BOOST_THROW_EXCEPTION(YCPPIllegalStateError{"Transaction has ended"});
+    }
+
+    try
+    {
+        vector<string> edit_configs = queue->get_edit_configs(options.max_edit_bytes);
+        session = make_unique<NetconfSessionPool::Session>(provider.session_pool->checkout());
+        (*session)->set_stats(&provider.stats);
+        if(options.lock)
+        {
+            NetconfReply reply = execute(get_datastore_rpc_payload("lock", candidate_supported));
+            check_ok_reply(reply);
+            locked = true;
+        }
+
+        for(auto & config : edit_configs)
+        {
+            NetconfReply reply = execute(get_edit_config_payload(*provider.root_schema, candidate_supported, config));
+            check_ok_reply(reply);
+        }
+        queue->clear();
+
+        if(candidate_supported)
+        {
+            NetconfReply reply = execute(options.confirmed ? get_confirmed_commit_rpc_payload(options.confirm_timeout)
+                                                          : get_commit_rpc_payload());
+            check_ok_reply(reply);
+        }
+    }
+    catch(...)
+    {
+        // whatever failed, the datastore is unlocked and the session goes back to the pool
+        abort();
+        throw;
+    }
+
+    if(options.confirmed && candidate_supported)
+    {
+        state = State::confirming;
+        return;
+    }
+    end();
+}
+
+void NetconfTransaction::confirm()
+{
+    if(state != State::confirming)
+    {
+        BOOST_LOG_TRIVIAL(error) << "Transaction has no commit to confirm";
+        BOOST_THROW_EXCEPTION(YCPPIllegalStateError{"Transaction has no commit to confirm"});
+    }
+    NetconfReply reply = execute(get_commit_rpc_payload());
+    check_ok_reply(reply);
+    end();
+}
+
+void NetconfTransaction::rollback()
+{
+    if(state == State::done)
+    {
+        return;
+    }
+    queue->clear();
+    if(state == State::confirming)
+    {
+        // without confirmed-commit:1.1 the device rolls back once confirm_timeout passes
+        auto & capabilities = provider.server_capabilities;
+        if(find(capabilities.begin(), capabilities.end(), CONFIRMED_COMMIT_1_1) != capabilities.end())
+        {
+            NetconfReply reply = execute(get_operation_rpc_payload("cancel-commit"));
+            check_ok_reply(reply);
+        }
+    }
+    end();
+}
+
+size_t NetconfTransaction::get_edit_count() const
+{
+    return queue->get_edit_configs(options.max_edit_bytes).size();
+}
+
+NetconfReply NetconfTransaction::execute(const string & payload)
+{
+    NetconfReply reply = (*session)->execute(payload);
+    BOOST_LOG_TRIVIAL(debug) <<"=============Reply payload=============";
+    BOOST_LOG_TRIVIAL(debug) << reply.c_str();
+    return reply;
+}
+
+// clears the candidate after a failed commit, errors are left to the one being reported
+void NetconfTransaction::abort()
+{
+    queue->clear();
+    try
+    {
+        if(candidate_supported && session)
+        {
+            execute(get_operation_rpc_payload("discard-changes"));
+        }
+    }
+    catch(YCPPError & e)
+    {
+        BOOST_LOG_TRIVIAL(error) << "Failed to discard changes: " << e.err_msg;
+    }
+    catch(...)
+    {
+        BOOST_LOG_TRIVIAL(error) << "Failed to discard changes";
+    }
+    try
+    {
+        end();
+    }
+    catch(YCPPError & e)
+    {
+        BOOST_LOG_TRIVIAL(error) << "Failed to unlock: " << e.err_msg;
+    }
+    catch(...)
+    {
+        BOOST_LOG_TRIVIAL(error) << "Failed to unlock";
+    }
+}
+
+// unlocks the datastore and hands the session back to the pool
+void NetconfTransaction::end()
+{
+    state = State::done;
+    unique_ptr<NetconfSessionPool::Session> held = move(session);
+    if(locked)
+    {
+        locked = false;
+        NetconfReply reply = (*held)->execute(get_datastore_rpc_payload("unlock", candidate_supported));
+        check_ok_reply(reply);
+    }
+}
+
 static unique_ptr<path::Rpc> create_rpc_instance(path::RootSchemaNode & root_schema, string rpc_name)
 {
 	auto rpc = unique_ptr<path::Rpc>(root_schema.rpc(rpc_name));
@@ -230,6 +841,37 @@ static string get_commit_rpc_payload()
 			"</rpc>";
 }
 
+static string get_confirmed_commit_rpc_payload(chrono::seconds confirm_timeout)
+{
+	return "<rpc xmlns=\"urn:ietf:params:xml:ns:netconf:base:1.0\">"
+		   "<commit><confirmed/><confirm-timeout>" + std::to_string(confirm_timeout.count()) + "</confirm-timeout></commit>"
+			"</rpc>";
+}
+
+// lock or unlock of the datastore edits go to
+static string get_datastore_rpc_payload(const string & operation, bool candidate_supported)
+{
+	return "<rpc xmlns=\"urn:ietf:params:xml:ns:netconf:base:1.0\">"
+		   "<" + operation + "><target>" + (candidate_supported ? "<candidate/>" : "<running/>") + "</target></" + operation + ">"
+			"</rpc>";
+}
+
+static string get_operation_rpc_payload(const string & operation)
+{
+	return "<rpc xmlns=\"urn:ietf:params:xml:ns:netconf:base:1.0\">"
+		   "<" + operation + "/>"
+			"</rpc>";
+}
+
+static void check_ok_reply(NetconfReply & reply)
+{
+	if(!reply.contains("<ok/>"))
+	{
+		BOOST_LOG_TRIVIAL(error) << "RPC error occurred: " << reply.c_str();
+		BOOST_THROW_EXCEPTION(YCPPServiceProviderError{reply.str()});
+	}
+}
+
 static bool is_candidate_supported(vector<string> capabilities)
 {
 	if(std::find(capabilities.begin(), capabilities.end(), CANDIDATE) != capabilities.end()){
@@ -273,36 +915,177 @@ static void create_input_source(path::DataNode & input, bool config)
 
 static string get_annotated_config_payload(path::RootSchemaNode* root_schema,
 		path::Rpc & rpc, path::Annotation & annotation)
+{
+    std::unique_ptr<const path::DataNode> decoded;
+    std::string config_payload {};
+    for(auto element : get_config(root_schema, rpc, decoded))
+    {
+        config_payload += get_annotated_xml(*root_schema, *element, annotation, decoded != nullptr);
+    }
+    return config_payload;
+}
+
+// the top level elements of the entity given to a crud rpc, decoded keeps the tree of an entity
+// given as xml
+static vector<path::DataNode*> get_config(path::RootSchemaNode* root_schema,
+		path::Rpc & rpc, unique_ptr<const path::DataNode> & decoded)
 {
     path::CodecService codec_service{};
-    auto entity = rpc.input()->find("entity");
-    if(entity.empty()){
-        BOOST_LOG_TRIVIAL(error) << "Failed to get entity node";
-        BOOST_THROW_EXCEPTION(YCPPInvalidArgumentError{"Failed to get entity node"});
+    //trees attached by reference are encoded as they are, only an entity given as xml needs decoding
+    std::vector<path::DataNode*> data_nodes = rpc.attached("entity");
+    if(data_nodes.empty())
+    {
+        auto entity = rpc.input()->find("entity");
+        if(entity.empty()){
+            BOOST_LOG_TRIVIAL(error) << "Failed to get entity node";
+            BOOST_THROW_EXCEPTION(YCPPInvalidArgumentError{"Failed to get entity node"});
+        }
+
+        path::DataNode* entity_node = entity[0];
+        std::string entity_value = entity_node->get();
+
+        //deserialize the entity_value
+        decoded.reset(codec_service.decode(root_schema, entity_value, path::CodecService::Format::XML));
+
+        if(!decoded){
+            BOOST_LOG_TRIVIAL(error) << "Failed to decode entity node";
+            BOOST_THROW_EXCEPTION(YCPPInvalidArgumentError{"Failed to decode entity node"});
+        }
+        data_nodes = decoded->children();
     }
+    return data_nodes;
+}
 
-    path::DataNode* entity_node = entity[0];
-    std::string entity_value = entity_node->get();
+// the xml of a top level element, annotated with the operation when the element has none of its
+// own; an element the provider does not own stays as the caller gave it and is annotated on a
+// copy, as the tree may be used again
+static string get_annotated_xml(path::RootSchemaNode & root_schema, path::DataNode & element,
+        const path::Annotation & annotation, bool owned)
+{
+    path::CodecService codec_service{};
+    if(!element.annotations().empty())
+    {
+        return codec_service.encode(&element, path::CodecService::Format::XML, true);
+    }
+    if(owned)
+    {
+        element.add_annotation(annotation);
+        return codec_service.encode(&element, path::CodecService::Format::XML, true);
+    }
 
-    //deserialize the entity_value
-    path::DataNode* datanode = codec_service.decode(root_schema, entity_value, path::CodecService::Format::XML);
+    unique_ptr<const path::DataNode> root;
+    path::DataNode* copy = copy_data_node(root_schema, element, root);
+    copy->add_annotation(annotation);
+    return codec_service.encode(copy, path::CodecService::Format::XML, true);
+}
 
-    if(!datanode){
-        BOOST_LOG_TRIVIAL(error) << "Failed to decode entity node";
-        BOOST_THROW_EXCEPTION(YCPPInvalidArgumentError{"Failed to decode entity node"});
+// the netconf operation a node is annotated with, empty when it inherits its parent's
+static string get_operation(path::DataNode & node)
+{
+    for(auto & annotation : node.annotations())
+    {
+        if(annotation.m_name == "operation")
+        {
+            return annotation.m_val;
+        }
     }
+    return "";
+}
 
-    std::string config_payload {};
+static bool is_leaf_data_node(path::DataNode & node)
+{
+    const string & keyword = node.schema()->statement().keyword;
+    return keyword == "leaf" || keyword == "leaf-list" || keyword == "anyxml";
+}
+
+// the nodes of source already in target have to carry the same operation in both
+static bool can_merge_data_node(path::DataNode & target, path::DataNode & source)
+{
+    string segment;
+    for(auto child : source.children())
+    {
+        segment.clear();
+        child->append_segment(segment);
+        auto existing = target.find(segment);
+        if(existing.empty())
+        {
+            continue;
+        }
+        if(get_operation(*child) != get_operation(*existing[0])
+           || (!is_leaf_data_node(*child) && !can_merge_data_node(*existing[0], *child)))
+        {
+            return false;
+        }
+    }
+    return true;
+}
 
-    for(auto const & child : datanode->children())
+// copies the children of source into target, the values of source win
+static void merge_data_node(path::DataNode & target, path::DataNode & source)
+{
+    string segment;
+    for(auto child : source.children())
     {
-    	if((child->annotations()).size()==0)
-    	{
-    		child->add_annotation(annotation);
-    	}
-        config_payload += codec_service.encode(child, path::CodecService::Format::XML, true);
+        segment.clear();
+        child->append_segment(segment);
+        bool leaf = is_leaf_data_node(*child);
+        auto existing = target.find(segment);
+        path::DataNode* merged = nullptr;
+        if(existing.empty())
+        {
+            merged = target.create(segment, leaf ? child->get() : "");
+            for(auto & annotation : child->annotations())
+            {
+                merged->add_annotation(annotation);
+            }
+        }
+        else
+        {
+            merged = existing[0];
+            if(leaf && merged->get() != child->get())
+            {
+                merged->set(child->get());
+            }
+        }
+
+        if(!leaf)
+        {
+            merge_data_node(*merged, *child);
+        }
     }
-    return config_payload;
+}
+
+// copies data node by node into a tree of its own, root is given the tree owning the copy
+static path::DataNode* copy_data_node(path::RootSchemaNode & root_schema, path::DataNode & data, unique_ptr<const path::DataNode> & root)
+{
+    string segment;
+    data.append_segment(segment);
+    path::DataNode* copy = root_schema.create(segment);
+    if(copy == nullptr)
+    {
+        BOOST_LOG_TRIVIAL(error) << "Could not copy " << data.path();
+        BOOST_THROW_EXCEPTION(YCPPServiceProviderError{"Could not copy " + data.path()});
+    }
+    root.reset(copy->root());
+    for(auto & annotation : data.annotations())
+    {
+        copy->add_annotation(annotation);
+    }
+    merge_data_node(*copy, data);
+    return copy;
+}
+
+static string get_edit_config_payload(path::RootSchemaNode & root_schema, bool candidate_supported, const string & config_payload)
+{
+    auto netconf_rpc = create_rpc_instance(root_schema, "ietf-netconf:edit-config");
+    auto input = create_rpc_input(*netconf_rpc);
+    create_input_target(*input, candidate_supported);
+    create_input_error_option(*input);
+
+    ly_verb(LY_LLSILENT); //turn off libyang logging at the beginning
+    string netconf_payload = get_netconf_payload(input, "config", config_payload);
+    ly_verb(LY_LLVRB); // enable libyang logging after payload has been created
+    return netconf_payload;
 }
 
 static string get_filter_payload(path::Rpc & ydk_rpc)
@@ -336,12 +1119,12 @@ static string get_netconf_payload(path::DataNode* input, string data_tag, string
     return payload;
 }
 
-static path::DataNode* handle_edit_reply(string reply, NetconfClient & client, bool candidate_supported)
+static path::DataNode* handle_edit_reply(NetconfReply & reply, const function<NetconfReply(const string &)> & execute, bool candidate_supported)
 {
-	if(reply.find("<ok/>") == std::string::npos)
+	if(!reply.contains("<ok/>"))
 	{
         BOOST_LOG_TRIVIAL(error) << "No ok in reply ";
-		BOOST_THROW_EXCEPTION(YCPPServiceProviderError{reply});
+		BOOST_THROW_EXCEPTION(YCPPServiceProviderError{reply.str()});
 	}
 
 	if(candidate_supported)
@@ -350,15 +1133,15 @@ static path::DataNode* handle_edit_reply(string reply, NetconfClient & client, b
 		string commit_payload = get_commit_rpc_payload();
 
 		BOOST_LOG_TRIVIAL(debug) << "Executing commit RPC: " << commit_payload;
-		reply = client.execute_payload(commit_payload);
+		reply = execute(commit_payload);
 
 		BOOST_LOG_TRIVIAL(debug) <<"=============Reply payload=============";
-		BOOST_LOG_TRIVIAL(debug) << reply;
+		BOOST_LOG_TRIVIAL(debug) << reply.c_str();
 		BOOST_LOG_TRIVIAL(debug) << endl;
-		if(reply.find("<ok/>") == std::string::npos)
+		if(!reply.contains("<ok/>"))
 		{
-			BOOST_LOG_TRIVIAL(error) << "RPC error occurred: " << reply;
-		    BOOST_THROW_EXCEPTION(YCPPServiceProviderError{reply});
+			BOOST_LOG_TRIVIAL(error) << "RPC error occurred: " << reply.c_str();
+		    BOOST_THROW_EXCEPTION(YCPPServiceProviderError{reply.str()});
 		}
 	}
 
@@ -366,32 +1149,29 @@ static path::DataNode* handle_edit_reply(string reply, NetconfClient & client, b
 	return nullptr;
 }
 
-static path::DataNode* handle_read_reply(string reply, path::RootSchemaNode * root_schema)
+static path::DataNode* handle_read_reply(NetconfReply & reply, path::RootSchemaNode * root_schema)
 {
 	path::CodecService codec_service{};
-	auto empty_data = reply.find("<data/>");
-	if(empty_data != std::string::npos)
+	if(reply.contains("<data/>"))
 	{
 		BOOST_LOG_TRIVIAL(debug) << "Found empty data tag";
 		return nullptr;
 	}
 
-	auto data_start = reply.find("<data>");
-	if(data_start == std::string::npos)
+	if(!reply.contains("<data>"))
 	{
-		BOOST_LOG_TRIVIAL(debug) << "Can't find data tag in reply " << reply;
-		BOOST_THROW_EXCEPTION(YCPPServiceProviderError{reply});
+		BOOST_LOG_TRIVIAL(debug) << "Can't find data tag in reply " << reply.c_str();
+		BOOST_THROW_EXCEPTION(YCPPServiceProviderError{reply.str()});
 	}
-	data_start+= sizeof("<data>") - 1;
-	auto data_end = reply.find("</data>", data_start);
-	if(data_end == std::string::npos)
+
+	//the data section is terminated in place and handed to the codec without a copy
+	const char* data = reply.data_section();
+	if(data == nullptr)
 	{
-		BOOST_LOG_TRIVIAL(debug) << "No end data tag found in reply " << reply;
+		BOOST_LOG_TRIVIAL(debug) << "No end data tag found in reply " << reply.c_str();
 		BOOST_THROW_EXCEPTION(YCPPError{"No end data tag found"});
 	}
 
-	string data = reply.substr(data_start, data_end-data_start);
-
 	auto datanode = codec_service.decode(root_schema, data, path::CodecService::Format::XML);
 
 	if(!datanode){
@@ -401,6 +1181,250 @@ static path::DataNode* handle_read_reply(string reply, path::RootSchemaNode * ro
 	return datanode;
 }
 
+static void add_read_reply(NetconfReply & reply, path::StreamingDecoder & decoder)
+{
+	if(reply.contains("<data/>"))
+	{
+		return;
+	}
+
+	const char* data = reply.data_section();
+	if(data == nullptr)
+	{
+		BOOST_LOG_TRIVIAL(debug) << "Can't find data tag in reply " << reply.c_str();
+		BOOST_THROW_EXCEPTION(YCPPServiceProviderError{reply.str()});
+	}
+	decoder.add(data);
+}
+
+// Splits a subtree filter into filters that select one subtree each, see split_filter_element.
+// The filters are sent as separate rpcs, so the merged result is not an atomic snapshot
+// of the datastore when it changes between the replies.
+static vector<string> split_filter(path::RootSchemaNode & root_schema, const string & filter)
+{
+	vector<string> filters;
+	for(auto & element : scan_filter(filter))
+	{
+		vector<string> element_filters = split_filter_element(root_schema, filter, element);
+		if(element_filters.size() < 2)
+		{
+			element_filters = {filter.substr(element.begin, element.end - element.begin)};
+		}
+		filters.insert(filters.end(), element_filters.begin(), element_filters.end());
+	}
+
+	if(filters.empty())
+	{
+		filters.push_back(filter);
+	}
+	return filters;
+}
+
+// finds the top level elements of the filter and the spans of their child elements
+static vector<FilterElement> scan_filter(const string & filter)
+{
+	vector<FilterElement> elements;
+	size_t depth = 0;
+	size_t child_begin = 0;
+	size_t pos = 0;
+	while((pos = filter.find('<', pos)) != string::npos)
+	{
+		size_t close = filter.find('>', pos);
+		if(close == string::npos)
+		{
+			break;
+		}
+
+		if(filter.compare(pos, 2, "<?") == 0 || filter.compare(pos, 2, "<!") == 0)
+		{
+			pos = close + 1;
+			continue;
+		}
+
+		if(filter.compare(pos, 2, "</") == 0)
+		{
+			if(depth > 0)
+			{
+				--depth;
+			}
+			if(depth == 1 && !elements.empty())
+			{
+				elements.back().children.push_back({child_begin, close + 1});
+			}
+			else if(depth == 0 && !elements.empty())
+			{
+				elements.back().end = close + 1;
+			}
+			pos = close + 1;
+			continue;
+		}
+
+		bool self_closing = filter[close - 1] == '/';
+		if(depth == 0)
+		{
+			string start_tag = filter.substr(pos, close + 1 - pos);
+			FilterElement element{start_tag, get_tag_name(start_tag), pos, close + 1, {}};
+			if(self_closing)
+			{
+				element.start_tag.erase(element.start_tag.size() - 2, 1);
+			}
+			elements.push_back(element);
+		}
+		else if(depth == 1)
+		{
+			child_begin = pos;
+			if(self_closing && !elements.empty())
+			{
+				elements.back().children.push_back({pos, close + 1});
+			}
+		}
+
+		if(!self_closing)
+		{
+			++depth;
+		}
+		pos = close + 1;
+	}
+	return elements;
+}
+
+// Splits a top level element at its container and list children, its leaf children stay
+// together in one filter. An empty top level element is split at the children of its
+// schema node, so that a filter selecting a whole model still gets split. A content match
+// node restricts the subtrees selected by its siblings, the element holding one is not split.
+static vector<string> split_filter_element(path::RootSchemaNode & root_schema, const string & filter,
+		const FilterElement & element)
+{
+	vector<string> filters;
+	path::SchemaReadLock read_lock{&root_schema};
+	const struct lys_node* top = find_top_node(root_schema, element);
+	if(top == nullptr)
+	{
+		return filters;
+	}
+
+	string end_tag = "</" + element.name + ">";
+	string leaves;
+	if(element.children.empty())
+	{
+		const struct lys_node* child = nullptr;
+		while((child = lys_getnext(child, top, nullptr, 0)) != nullptr)
+		{
+			if(!(child->nodetype & (LYS_CONTAINER | LYS_LIST | LYS_LEAF | LYS_LEAFLIST | LYS_ANYXML)))
+			{
+				continue;
+			}
+			string selection = string{"<"} + child->name + " xmlns=\"" + lys_node_module(child)->ns + "\"/>";
+			if(child->nodetype & (LYS_CONTAINER | LYS_LIST))
+			{
+				filters.push_back(element.start_tag + selection + end_tag);
+			}
+			else
+			{
+				leaves += selection;
+			}
+		}
+	}
+	else
+	{
+		for(auto & span : element.children)
+		{
+			string child = filter.substr(span.first, span.second - span.first);
+			if(is_content_match_node(child))
+			{
+				return {};
+			}
+			const struct lys_node* child_node = find_child_node(top, get_tag_name(child));
+			if(child_node != nullptr && (child_node->nodetype & (LYS_CONTAINER | LYS_LIST)))
+			{
+				filters.push_back(element.start_tag + child + end_tag);
+			}
+			else
+			{
+				leaves += child;
+			}
+		}
+	}
+
+	if(!leaves.empty())
+	{
+		filters.push_back(element.start_tag + leaves + end_tag);
+	}
+	return filters;
+}
+
+static const struct lys_node* find_top_node(path::RootSchemaNode & root_schema, const FilterElement & element)
+{
+	auto rs_impl = dynamic_cast<path::RootSchemaNodeImpl*>(&root_schema);
+	string name_space = get_default_namespace(element.start_tag);
+	if(rs_impl == nullptr || name_space.empty())
+	{
+		return nullptr;
+	}
+
+	const struct lys_module* module = ly_ctx_get_module_by_ns(rs_impl->m_ctx, name_space.c_str(), nullptr);
+	if(module == nullptr)
+	{
+		return nullptr;
+	}
+
+	string local_name = element.name.substr(element.name.find(':') + 1);
+	const struct lys_node* top = nullptr;
+	while((top = lys_getnext(top, nullptr, module, 0)) != nullptr && local_name != top->name)
+	{
+	}
+	if(top == nullptr || top->nodetype != LYS_CONTAINER)
+	{
+		return nullptr;
+	}
+	return top;
+}
+
+static const struct lys_node* find_child_node(const struct lys_node* parent, const string & name)
+{
+	string local_name = name.substr(name.find(':') + 1);
+	const struct lys_node* child = nullptr;
+	while((child = lys_getnext(child, parent, nullptr, 0)) != nullptr && local_name != child->name)
+	{
+	}
+	return child;
+}
+
+// a content match node is a leaf element holding a value instead of child elements
+static bool is_content_match_node(const string & element)
+{
+	size_t start_end = element.find('>');
+	if(start_end == string::npos || element[start_end - 1] == '/')
+	{
+		return false;
+	}
+	size_t end_begin = element.rfind("</");
+	if(end_begin == string::npos || end_begin <= start_end)
+	{
+		return false;
+	}
+	string content = element.substr(start_end + 1, end_begin - start_end - 1);
+	return content.find('<') == string::npos && content.find_first_not_of(" \t\r\n") != string::npos;
+}
+
+static string get_tag_name(const string & tag)
+{
+	size_t end = tag.find_first_of(" \t\r\n/>", 1);
+	return tag.substr(1, end - 1);
+}
+
+static string get_default_namespace(const string & tag)
+{
+	string attribute = "xmlns=\"";
+	size_t begin = tag.find(attribute);
+	if(begin == string::npos)
+	{
+		return "";
+	}
+	begin += attribute.size();
+	return tag.substr(begin, tag.find('"', begin) - begin);
+}
+
 static string get_read_rpc_name(bool config)
 {
     if(config)
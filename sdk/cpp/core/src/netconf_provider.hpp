@@ -17,14 +17,46 @@
 #ifndef _NETCONF_PROVIDER_H_
 #define _NETCONF_PROVIDER_H_
 
+#include <chrono>
+#include <functional>
 #include <memory>
 #include <string>
+#include <vector>
 
+#include "netconf_notification.hpp"
+#include "netconf_reactor.hpp"
+#include "netconf_session_pool.hpp"
+#include "netconf_stats.hpp"
+#include "netconf_transport.hpp"
 #include "path_api.hpp"
+#include "startup_profile.hpp"
 
 namespace ydk {
 
 class NetconfClient;
+class NetconfReply;
+class NetconfTransaction;
+
+enum class ReadMode {
+        // the whole reply is received, then decoded
+        whole,
+        // the filter is split into subtrees requested with pipelined rpcs, each reply
+        // is decoded while the following ones are still on their way; the subtrees
+        // are separate reads, not an atomic snapshot of the datastore
+        streaming
+};
+
+struct NetconfTransactionOptions
+{
+        // lock the target datastore from the start of the commit until the transaction ends
+        bool lock = true;
+        // commit with <confirmed/>, the device rolls the commit back unless confirm() follows
+        // within confirm_timeout. Needs the :candidate and :confirmed-commit capabilities.
+        bool confirmed = false;
+        std::chrono::seconds confirm_timeout = std::chrono::seconds{600};
+        // queued edits are merged into edit-configs of up to about this many bytes
+        std::size_t max_edit_bytes = 1024 * 1024;
+};
 
 class NetconfServiceProvider : public path::ServiceProvider {
 public:
@@ -37,27 +69,151 @@ public:
                                std::string username,
                                std::string password,
                                int port);
+        NetconfServiceProvider(path::Repository & repo,
+                               std::string address,
+                               std::string username,
+                               std::string password,
+                               int port,
+                               const NetconfSessionPoolOptions & pool_options);
+        NetconfServiceProvider(std::string address,
+                               std::string username,
+                               std::string password,
+                               int port,
+                               const NetconfSessionPoolOptions & pool_options);
+        // sessions are connected through the given transport, e.g. TLS or a Unix domain socket
+        NetconfServiceProvider(path::Repository & repo,
+                               const NetconfTransport & transport,
+                               const NetconfSessionPoolOptions & pool_options = NetconfSessionPoolOptions{});
+        NetconfServiceProvider(const NetconfTransport & transport,
+                               const NetconfSessionPoolOptions & pool_options = NetconfSessionPoolOptions{});
+        NetconfServiceProvider(NetconfReactor & reactor,
+                               path::Repository & repo,
+                               std::string address,
+                               std::string username,
+                               std::string password,
+                               int port);
         ~NetconfServiceProvider();
         path::RootSchemaNode* get_root_schema() const;
         path::DataNode* invoke(path::Rpc* rpc) const;
+        bool supports_attached_data(const std::string & name) const;
+        void record_read_populate(bool config, std::chrono::steady_clock::duration elapsed) const;
         std::string execute_payload(std::string payload);
 
+        void set_read_mode(ReadMode mode);
+        ReadMode get_read_mode() const;
+
+        // per rpc timings of the operations executed through this provider, recorded
+        // once turned on with set_enabled(true)
+        NetconfStats & get_stats() const;
+        // time spent in each step of constructing this provider
+        const StartupProfile & get_startup_profile() const;
+
+        // closes the pool sessions idle for longer than its idle_timeout and probes those idle
+        // for longer than its keepalive_interval, discarding dead ones. Meant to be called
+        // periodically, e.g. from a timer of the application. Does nothing with a reactor.
+        void keepalive();
+
+        // starts a transaction, which holds a session of the pool from its commit until it
+        // ends; the provider has to outlive the transaction. Not supported for providers
+        // driven by a reactor.
+        std::unique_ptr<NetconfTransaction> begin_transaction(const NetconfTransactionOptions & options = NetconfTransactionOptions{});
+
+        // subscribes to notifications on a session of its own, the provider has to outlive
+        // the subscription. Not supported for providers driven by a reactor.
+        std::unique_ptr<NetconfSubscription> subscribe(const NetconfSubscriptionOptions & options = NetconfSubscriptionOptions{});
+        // as above, handing each notification to callback on the subscription's receiver thread
+        std::unique_ptr<NetconfSubscription> subscribe(const NetconfSubscriptionOptions & options,
+                                                       NetconfSubscription::Callback callback);
+
 private:
+        typedef std::function<NetconfReply(const std::string &)> PayloadExecutor;
+        // sends all the payloads before collecting their replies, which are handed over in order
+        typedef std::function<void(const std::vector<std::string> &,
+                                   const std::function<void(NetconfReply &)> &)> PipelineExecutor;
+
+        // an idempotent operation is repeated once on a new session if its session drops
+        path::DataNode* on_session(std::function<path::DataNode*(const PayloadExecutor &)> operation,
+                                   bool idempotent = false) const;
+        path::DataNode* on_pipelined_session(std::function<path::DataNode*(const PipelineExecutor &)> operation,
+                                             bool idempotent = false) const;
+        path::DataNode* on_pooled_session(std::function<path::DataNode*(NetconfClient &)> operation,
+                                          bool idempotent) const;
         path::DataNode* handle_edit(path::Rpc* rpc, path::Annotation ann) const;
         path::DataNode* handle_read(path::Rpc* rpc) const;
+        path::DataNode* handle_streaming_read(path::Rpc* rpc) const;
         void initialize();
 
 private:
         std::unique_ptr<path::Repository> m_repo_ptr;
         path::Repository & m_repo;
-        std::unique_ptr<NetconfClient> client;
+        mutable NetconfStats stats;
+        // current on the constructing thread until initialize() is done, so the sessions
+        // and the repository record the steps they take
+        StartupProfile startup_profile;
+        StartupProfile::Scope startup_scope{startup_profile};
+        std::unique_ptr<NetconfSessionPool> session_pool;
+        NetconfReactor * reactor;
+        NetconfReactor::SessionId reactor_session;
         std::unique_ptr<path::ModelProvider> model_provider;
-        std::unique_ptr<ydk::path::RootSchemaNode> root_schema;
+        std::shared_ptr<ydk::path::RootSchemaNode> root_schema;
 
         std::vector<std::string> server_capabilities;
 
         bool ietf_nc_monitoring_available = false;
+        ReadMode read_mode = ReadMode::whole;
+
+        friend class NetconfTransaction;
+};
 
+// Queues CRUD edits and sends them with as few edit-configs as possible followed by a
+// single commit. The transaction is a ServiceProvider itself: CrudService edits given the
+// transaction in place of the provider are queued, other operations are rejected. The
+// edits to a top level element are merged into one tree, a delete followed by writes to
+// the element becoming a replace; an edit which cannot be merged, such as a delete after
+// a write or a nested node edited with different operations, goes in a later edit-config.
+// The edits only reach the device on commit(), which checks a session out of the pool and
+// holds it until the transaction ends, after confirm() for a confirmed commit.
+//
+// Without the :candidate capability the edit-configs go to the running datastore and
+// there is nothing to commit; an edit-config failing then leaves the ones before it applied.
+class NetconfTransaction : public path::ServiceProvider {
+public:
+        NetconfTransaction(const NetconfServiceProvider & provider, const NetconfTransactionOptions & options);
+        // rolls back a transaction which was not committed
+        ~NetconfTransaction();
+
+        path::RootSchemaNode* get_root_schema() const;
+        path::DataNode* invoke(path::Rpc* rpc) const;
+        bool supports_attached_data(const std::string & name) const;
+
+        void commit();
+        // confirms a confirmed commit
+        void confirm();
+        // drops the queued edits, or cancels a confirmed commit waiting for confirm()
+        void rollback();
+
+        // number of edit-configs the queued edits will be sent with
+        std::size_t get_edit_count() const;
+
+private:
+        enum class State { open, confirming, done };
+
+        struct EditQueue;
+
+        NetconfReply execute(const std::string & payload);
+        void abort();
+        void end();
+
+private:
+        const NetconfServiceProvider & provider;
+        NetconfTransactionOptions options;
+        bool candidate_supported;
+        State state;
+        // checked out of the pool by commit() until the transaction ends
+        std::unique_ptr<NetconfSessionPool::Session> session;
+        bool locked;
+        // filled by invoke(), which the ServiceProvider interface makes const
+        std::unique_ptr<EditQueue> queue;
 };
 }
 
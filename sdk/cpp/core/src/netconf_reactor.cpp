@@ -0,0 +1,581 @@
+/// YANG Development Kit
+// Copyright 2016 Cisco Systems. All rights reserved
+//
+////////////////////////////////////////////////////////////////
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+//
+//////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include <deque>
+#include <thread>
+
+#include <fcntl.h>
+#include <unistd.h>
+#ifdef __linux__
+#include <sys/epoll.h>
+#else
+#include <poll.h>
+#endif
+
+#include <boost/log/trivial.hpp>
+
+#include "netconf_client.hpp"
+#include "netconf_transport.hpp"
+#include "netconf_reactor.hpp"
+
+using namespace std;
+
+namespace ydk
+{
+// libssh may buffer a reply while an rpc is being written, so sessions with rpcs in
+// flight are also polled when no socket became readable for this long
+static const int SWEEP_INTERVAL_MS = 100;
+static const int MAX_EVENTS = 256;
+
+static void complete(const NetconfReactor::Completion & completion, const string & reply, exception_ptr error);
+
+#ifdef __linux__
+class Poller
+{
+public:
+	Poller() : epoll_fd(epoll_create1(EPOLL_CLOEXEC))
+	{
+		if(epoll_fd < 0)
+		{
+			BOOST_LOG_TRIVIAL(error) << "Could not create epoll instance";
+			BOOST_THROW_EXCEPTION(YCPPClientError{"Could not create epoll instance"});
+		}
+	}
+
+	~Poller()
+	{
+		close(epoll_fd);
+	}
+
+	void add(int fd, void* data)
+	{
+		epoll_event event{};
+		event.events = EPOLLIN;
+		event.data.ptr = data;
+		if(epoll_ctl(epoll_fd, EPOLL_CTL_ADD, fd, &event) != 0)
+		{
+			BOOST_LOG_TRIVIAL(error) << "Could not watch descriptor " << fd;
+			BOOST_THROW_EXCEPTION(YCPPClientError{"Could not watch session descriptor"});
+		}
+	}
+
+	void remove(int fd)
+	{
+		epoll_ctl(epoll_fd, EPOLL_CTL_DEL, fd, NULL);
+	}
+
+	void wait(int timeout, vector<void*> & ready)
+	{
+		epoll_event events[MAX_EVENTS];
+		int count = epoll_wait(epoll_fd, events, MAX_EVENTS, timeout);
+		for(int i = 0; i < count; ++i)
+		{
+			ready.push_back(events[i].data.ptr);
+		}
+	}
+
+private:
+	int epoll_fd;
+};
+#else
+// poll(2) based fallback for platforms without epoll
+class Poller
+{
+public:
+	void add(int fd, void* data)
+	{
+		fds.push_back(pollfd{fd, POLLIN, 0});
+		fd_data.push_back(data);
+	}
+
+	void remove(int fd)
+	{
+		for(size_t i = 0; i < fds.size(); ++i)
+		{
+			if(fds[i].fd == fd)
+			{
+				fds.erase(fds.begin() + i);
+				fd_data.erase(fd_data.begin() + i);
+				return;
+			}
+		}
+	}
+
+	void wait(int timeout, vector<void*> & ready)
+	{
+		if(poll(fds.data(), fds.size(), timeout) <= 0)
+		{
+			return;
+		}
+		for(size_t i = 0; i < fds.size(); ++i)
+		{
+			if(fds[i].revents & (POLLIN | POLLHUP | POLLERR))
+			{
+				ready.push_back(fd_data[i]);
+			}
+		}
+	}
+
+private:
+	vector<pollfd> fds;
+	vector<void*> fd_data;
+};
+#endif
+
+struct NetconfReactor::Session
+{
+	SessionId id;
+	unique_ptr<NetconfClient> client;
+	vector<string> capabilities;
+	string hostname_port;
+	Loop* loop;
+
+	// owned by the reactor thread of the loop
+	int fd = -1;
+	bool failed = false;
+	deque<pair<string, Completion>> queued;
+	map<string, Completion> in_flight;
+};
+
+class NetconfReactor::Loop
+{
+public:
+	explicit Loop(const NetconfReactorOptions & options);
+	~Loop();
+
+	void add(shared_ptr<Session> session);
+	void remove(shared_ptr<Session> session);
+	void submit(shared_ptr<Session> session, string payload, Completion completion);
+
+private:
+	void post(function<void()> command);
+	void run();
+	bool run_commands();
+	// returns whether an rpc was sent
+	bool flush(Session & session);
+	void drain(Session & session);
+	void fail(Session & session, exception_ptr error);
+
+private:
+	const NetconfReactorOptions & options;
+	Poller poller;
+	int wakeup_fds[2];
+
+	mutex commands_mutex;
+	deque<function<void()>> commands;
+	bool stopping;
+
+	map<void*, shared_ptr<Session>> sessions;
+	size_t in_flight_count;
+
+	thread worker;
+};
+
+NetconfReactor::Loop::Loop(const NetconfReactorOptions & options)
+	: options(options), stopping(false), in_flight_count(0)
+{
+	if(pipe(wakeup_fds) != 0)
+	{
+		BOOST_LOG_TRIVIAL(error) << "Could not create reactor wakeup pipe";
+		BOOST_THROW_EXCEPTION(YCPPClientError{"Could not create reactor wakeup pipe"});
+	}
+	fcntl(wakeup_fds[0], F_SETFL, fcntl(wakeup_fds[0], F_GETFL) | O_NONBLOCK);
+	poller.add(wakeup_fds[0], NULL);
+	worker = thread{&Loop::run, this};
+}
+
+NetconfReactor::Loop::~Loop()
+{
+	post([this]() { stopping = true; });
+	worker.join();
+	close(wakeup_fds[0]);
+	close(wakeup_fds[1]);
+}
+
+void NetconfReactor::Loop::add(shared_ptr<Session> session)
+{
+	post([this, session]() {
+		try
+		{
+			session->fd = session->client->get_event_fd();
+			poller.add(session->fd, session.get());
+			sessions[session.get()] = session;
+		}
+		catch(...)
+		{
+			session->failed = true;
+		}
+	});
+}
+
+void NetconfReactor::Loop::remove(shared_ptr<Session> session)
+{
+	post([this, session]() {
+		fail(*session, make_exception_ptr(YCPPClientError{"Session to " + session->hostname_port + " was disconnected"}));
+	});
+}
+
+void NetconfReactor::Loop::submit(shared_ptr<Session> session, string payload, Completion completion)
+{
+	post([this, session, payload, completion]() {
+		if(session->failed)
+		{
+			complete(completion, "", make_exception_ptr(YCPPClientError{"Session to " + session->hostname_port + " has failed"}));
+			return;
+		}
+		if(session->queued.size() >= options.max_queued)
+		{
+			complete(completion, "", make_exception_ptr(YCPPClientError{"Request queue to " + session->hostname_port + " is full"}));
+			return;
+		}
+		session->queued.emplace_back(payload, completion);
+		drain(*session);
+	});
+}
+
+void NetconfReactor::Loop::post(function<void()> command)
+{
+	{
+		lock_guard<mutex> lock{commands_mutex};
+		commands.push_back(move(command));
+	}
+	char wakeup = 0;
+	if(write(wakeup_fds[1], &wakeup, 1) < 0)
+	{
+		BOOST_LOG_TRIVIAL(debug) << "Reactor wakeup pipe is full";
+	}
+}
+
+void NetconfReactor::Loop::run()
+{
+	vector<void*> ready;
+	while(true)
+	{
+		ready.clear();
+		poller.wait(in_flight_count > 0 ? SWEEP_INTERVAL_MS : -1, ready);
+
+		bool woken = false;
+		for(auto data : ready)
+		{
+			if(data == NULL)
+			{
+				woken = true;
+				continue;
+			}
+			auto session = sessions.find(data);
+			if(session != sessions.end())
+			{
+				auto keep_alive = session->second;
+				drain(*keep_alive);
+			}
+		}
+
+		if(woken && !run_commands())
+		{
+			break;
+		}
+
+		if(ready.empty() && in_flight_count > 0)
+		{
+			vector<shared_ptr<Session>> waiting;
+			for(auto & session : sessions)
+			{
+				if(!session.second->in_flight.empty())
+				{
+					waiting.push_back(session.second);
+				}
+			}
+			for(auto & session : waiting)
+			{
+				drain(*session);
+			}
+		}
+	}
+
+	auto remaining = sessions;
+	for(auto & session : remaining)
+	{
+		fail(*session.second, make_exception_ptr(YCPPClientError{"Reactor was stopped"}));
+	}
+}
+
+bool NetconfReactor::Loop::run_commands()
+{
+	char buffer[256];
+	while(read(wakeup_fds[0], buffer, sizeof(buffer)) > 0)
+	{
+	}
+
+	deque<function<void()>> pending;
+	{
+		lock_guard<mutex> lock{commands_mutex};
+		pending.swap(commands);
+	}
+	for(auto & command : pending)
+	{
+		command();
+	}
+	return !stopping;
+}
+
+bool NetconfReactor::Loop::flush(Session & session)
+{
+	bool sent = false;
+	while(!session.failed && !session.queued.empty() && session.in_flight.size() < options.max_in_flight)
+	{
+		auto request = move(session.queued.front());
+		session.queued.pop_front();
+
+		string message_id;
+		try
+		{
+			message_id = session.client->send_payload(request.first);
+		}
+		catch(...)
+		{
+			auto error = current_exception();
+			complete(request.second, "", error);
+			fail(session, error);
+			return false;
+		}
+		session.in_flight.emplace(message_id, move(request.second));
+		++in_flight_count;
+		sent = true;
+	}
+	return sent;
+}
+
+// libssh may have buffered replies while the rpcs freeing their slots were written, which
+// epoll does not report, so the session is polled again until a poll finds nothing new
+void NetconfReactor::Loop::drain(Session & session)
+{
+	do
+	{
+		if(session.failed)
+		{
+			return;
+		}
+
+		try
+		{
+			string message_id, reply;
+			while(session.client->poll_reply(message_id, reply))
+			{
+				auto request = session.in_flight.find(message_id);
+				if(request == session.in_flight.end())
+				{
+					BOOST_LOG_TRIVIAL(debug) << "Dropping unexpected reply with message-id " << message_id;
+					continue;
+				}
+				auto completion = move(request->second);
+				session.in_flight.erase(request);
+				--in_flight_count;
+				complete(completion, reply, nullptr);
+			}
+		}
+		catch(...)
+		{
+			fail(session, current_exception());
+			return;
+		}
+	}
+	while(flush(session));
+}
+
+void NetconfReactor::Loop::fail(Session & session, exception_ptr error)
+{
+	if(!session.failed)
+	{
+		BOOST_LOG_TRIVIAL(debug) << "Closing reactor session to " << session.hostname_port;
+		session.failed = true;
+	}
+	if(session.fd >= 0)
+	{
+		poller.remove(session.fd);
+		session.fd = -1;
+	}
+
+	in_flight_count -= session.in_flight.size();
+	for(auto & request : session.in_flight)
+	{
+		complete(request.second, "", error);
+	}
+	session.in_flight.clear();
+	for(auto & request : session.queued)
+	{
+		complete(request.second, "", error);
+	}
+	session.queued.clear();
+
+	session.client.reset();
+	sessions.erase(&session);
+}
+
+NetconfReactor::NetconfReactor(const NetconfReactorOptions & options)
+	: options(options), next_id(1)
+{
+	this->options.num_threads = max<size_t>(this->options.num_threads, 1);
+	this->options.max_in_flight = max<size_t>(this->options.max_in_flight, 1);
+	for(size_t i = 0; i < this->options.num_threads; ++i)
+	{
+		loops.push_back(make_unique<Loop>(this->options));
+	}
+}
+
+NetconfReactor::~NetconfReactor()
+{
+	loops.clear();
+}
+
+NetconfReactor::SessionId NetconfReactor::connect(string username, string password, string address, int port,
+		NetconfStats * stats)
+{
+	return connect(SshTransport{username, password, address, port}, stats);
+}
+
+NetconfReactor::SessionId NetconfReactor::connect(const NetconfTransport & transport, NetconfStats * stats)
+{
+	auto session = make_shared<Session>();
+	session->client = make_unique<NetconfClient>(transport.clone(), 0);
+	session->client->set_stats(stats);
+	session->client->connect();
+	session->capabilities = session->client->get_capabilities();
+	session->hostname_port = session->client->get_hostname_port();
+
+	{
+		lock_guard<mutex> lock{sessions_mutex};
+		session->id = next_id++;
+		session->loop = loops[session->id % loops.size()].get();
+		sessions[session->id] = session;
+	}
+	session->loop->add(session);
+	BOOST_LOG_TRIVIAL(debug) << "Reactor session " << session->id << " connected to " << session->hostname_port;
+	return session->id;
+}
+
+void NetconfReactor::connect_async(string username, string password, string address, int port,
+		ConnectCompletion completion, TaskExecutor & executor)
+{
+	executor.post([this, username, password, address, port, completion]() {
+		SessionId id = 0;
+		try
+		{
+			id = connect(username, password, address, port);
+		}
+		catch(...)
+		{
+			completion(0, current_exception());
+			return;
+		}
+		completion(id, nullptr);
+	});
+}
+
+void NetconfReactor::disconnect(SessionId id)
+{
+	shared_ptr<Session> session;
+	{
+		lock_guard<mutex> lock{sessions_mutex};
+		auto found = sessions.find(id);
+		if(found == sessions.end())
+		{
+			return;
+		}
+		session = found->second;
+		sessions.erase(found);
+	}
+	session->loop->remove(session);
+}
+
+void NetconfReactor::submit(SessionId id, string payload, Completion completion)
+{
+	auto session = find_session(id);
+	session->loop->submit(session, move(payload), move(completion));
+}
+
+future<string> NetconfReactor::submit(SessionId id, string payload)
+{
+	auto reply = make_shared<promise<string>>();
+	submit(id, move(payload), [reply](const string & payload, exception_ptr error) {
+		if(error)
+		{
+			reply->set_exception(error);
+		}
+		else
+		{
+			reply->set_value(payload);
+		}
+	});
+	return reply->get_future();
+}
+
+string NetconfReactor::execute_payload(SessionId id, const string & payload)
+{
+	return submit(id, payload).get();
+}
+
+vector<string> NetconfReactor::get_capabilities(SessionId id)
+{
+	return find_session(id)->capabilities;
+}
+
+string NetconfReactor::get_hostname_port(SessionId id)
+{
+	return find_session(id)->hostname_port;
+}
+
+size_t NetconfReactor::size()
+{
+	lock_guard<mutex> lock{sessions_mutex};
+	return sessions.size();
+}
+
+shared_ptr<NetconfReactor::Session> NetconfReactor::find_session(SessionId id)
+{
+	lock_guard<mutex> lock{sessions_mutex};
+	auto session = sessions.find(id);
+	if(session == sessions.end())
+	{
+		BOOST_LOG_TRIVIAL(error) << "No reactor session with id " << id;
+		BOOST_THROW_EXCEPTION(YCPPInvalidArgumentError{"No reactor session with id " + to_string(id)});
+	}
+	return session->second;
+}
+
+static void complete(const NetconfReactor::Completion & completion, const string & reply, exception_ptr error)
+{
+	try
+	{
+		completion(reply, error);
+	}
+	catch(const exception & e)
+	{
+		BOOST_LOG_TRIVIAL(error) << "Reactor completion failed: " << e.what();
+	}
+	catch(...)
+	{
+		BOOST_LOG_TRIVIAL(error) << "Reactor completion failed with an unknown error";
+	}
+}
+}
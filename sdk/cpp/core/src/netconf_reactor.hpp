@@ -0,0 +1,97 @@
+/*  ----------------------------------------------------------------
+ Copyright 2016 Cisco Systems
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+------------------------------------------------------------------*/
+
+#ifndef _NETCONF_REACTOR_H_
+#define _NETCONF_REACTOR_H_
+
+#include <exception>
+#include <functional>
+#include <future>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "task_executor.hpp"
+
+namespace ydk {
+
+class NetconfStats;
+class NetconfTransport;
+
+struct NetconfReactorOptions
+{
+	// number of reactor threads the sessions are spread over
+	std::size_t num_threads = 1;
+	// RPCs pipelined on one session before further requests are queued
+	std::size_t max_in_flight = 16;
+	// requests queued on one session before new ones are rejected
+	std::size_t max_queued = 1024;
+};
+
+// Drives many NETCONF sessions from a fixed set of reactor threads. Each session is owned
+// by one reactor thread, which sends queued requests, waits for the session sockets to become
+// readable and completes requests as their replies arrive.
+//
+// libnetconf performs the SSH handshake and the hello exchange synchronously, so connect_async
+// runs them on a TaskExecutor; the session is handed to a reactor thread once it is established.
+class NetconfReactor
+{
+public:
+	typedef std::size_t SessionId;
+	// called on a reactor thread with either the reply or the error; must not block
+	typedef std::function<void(const std::string & reply, std::exception_ptr error)> Completion;
+	typedef std::function<void(SessionId id, std::exception_ptr error)> ConnectCompletion;
+
+public:
+	explicit NetconfReactor(const NetconfReactorOptions & options = NetconfReactorOptions{});
+	~NetconfReactor();
+
+	// the rpcs of the session are timed to stats when one is given, it has to outlive the session
+	SessionId connect(std::string username, std::string password, std::string address, int port,
+			NetconfStats * stats = nullptr);
+	SessionId connect(const NetconfTransport & transport, NetconfStats * stats = nullptr);
+	void connect_async(std::string username, std::string password, std::string address, int port,
+			ConnectCompletion completion, TaskExecutor & executor = get_default_executor());
+	void disconnect(SessionId id);
+
+	void submit(SessionId id, std::string payload, Completion completion);
+	std::future<std::string> submit(SessionId id, std::string payload);
+	// blocks the caller until the reply arrives, must not be called from a completion
+	std::string execute_payload(SessionId id, const std::string & payload);
+
+	std::vector<std::string> get_capabilities(SessionId id);
+	std::string get_hostname_port(SessionId id);
+	std::size_t size();
+
+private:
+	struct Session;
+	class Loop;
+
+	std::shared_ptr<Session> find_session(SessionId id);
+
+private:
+	NetconfReactorOptions options;
+	std::vector<std::unique_ptr<Loop>> loops;
+
+	std::mutex sessions_mutex;
+	std::map<SessionId, std::shared_ptr<Session>> sessions;
+	SessionId next_id;
+};
+}
+
+#endif /*_NETCONF_REACTOR_H_*/
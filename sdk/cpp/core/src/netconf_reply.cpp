@@ -0,0 +1,163 @@
+/// YANG Development Kit
+// Copyright 2016 Cisco Systems. All rights reserved
+//
+////////////////////////////////////////////////////////////////
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+//
+//////////////////////////////////////////////////////////////////
+
+#include <cstdlib>
+#include <cstring>
+
+#include "netconf_reply.hpp"
+
+using namespace std;
+
+namespace ydk
+{
+static const char* DATA_START = "<data";
+static const char* DATA_END = "</data>";
+
+NetconfReply::NetconfReply()
+	: buffer(nullptr), length(0), allocated(false)
+{
+}
+
+NetconfReply::NetconfReply(char* buffer)
+	: buffer(buffer), length(buffer != nullptr ? strlen(buffer) : 0), allocated(true)
+{
+}
+
+NetconfReply::NetconfReply(string buffer)
+	: buffer(nullptr), length(buffer.size()), storage(move(buffer)), allocated(false)
+{
+	this->buffer = &storage[0];
+}
+
+NetconfReply::NetconfReply(NetconfReply && other)
+	: NetconfReply()
+{
+	*this = move(other);
+}
+
+NetconfReply & NetconfReply::operator=(NetconfReply && other)
+{
+	if(this != &other)
+	{
+		reset();
+		allocated = other.allocated;
+		length = other.length;
+		if(allocated)
+		{
+			buffer = other.buffer;
+		}
+		else
+		{
+			// the characters of a short string live inside the string object itself
+			size_t offset = other.buffer != nullptr ? other.buffer - &other.storage[0] : 0;
+			storage = move(other.storage);
+			buffer = other.buffer != nullptr ? &storage[0] + offset : nullptr;
+		}
+		other.buffer = nullptr;
+		other.length = 0;
+		other.allocated = false;
+	}
+	return *this;
+}
+
+NetconfReply::~NetconfReply()
+{
+	reset();
+}
+
+const char* NetconfReply::c_str() const
+{
+	return buffer != nullptr ? buffer : "";
+}
+
+size_t NetconfReply::size() const
+{
+	return length;
+}
+
+string NetconfReply::str() const
+{
+	return string(c_str(), length);
+}
+
+bool NetconfReply::contains(const char* text) const
+{
+	return buffer != nullptr && strstr(buffer, text) != nullptr;
+}
+
+const char* NetconfReply::data_section()
+{
+	if(buffer == nullptr)
+	{
+		return nullptr;
+	}
+
+	char* start = buffer;
+	while((start = strstr(start, DATA_START)) != nullptr)
+	{
+		char next = start[strlen(DATA_START)];
+		if(next == '>' || next == ' ' || next == '\t' || next == '\r' || next == '\n')
+		{
+			break;
+		}
+		start += strlen(DATA_START);
+	}
+	if(start == nullptr)
+	{
+		return nullptr;
+	}
+	start = strchr(start, '>');
+	if(start == nullptr || start[-1] == '/')
+	{
+		return nullptr;
+	}
+	++start;
+
+	// the closing tag of the data element is the last one, nested elements may be called data too
+	char* end = nullptr;
+	for(char* found = strstr(start, DATA_END); found != nullptr; found = strstr(found + 1, DATA_END))
+	{
+		end = found;
+	}
+	if(end == nullptr)
+	{
+		return nullptr;
+	}
+
+	*end = '\0';
+	length = end - buffer;
+	return start;
+}
+
+void NetconfReply::reset()
+{
+	if(allocated)
+	{
+		free(buffer);
+	}
+	buffer = nullptr;
+	length = 0;
+	storage.clear();
+	allocated = false;
+}
+}
@@ -0,0 +1,63 @@
+/*  ----------------------------------------------------------------
+ Copyright 2016 Cisco Systems
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+------------------------------------------------------------------*/
+
+#ifndef _YDK_NETCONF_REPLY_H_
+#define _YDK_NETCONF_REPLY_H_
+
+#include <string>
+
+namespace ydk
+{
+
+// Owns the text of one rpc-reply, either the buffer allocated by libnetconf when the
+// reply was dumped or a string handed over by the caller. The reply is not copied
+// again on its way to the codec: data_section() terminates the <data> element in place.
+class NetconfReply
+{
+public:
+	NetconfReply();
+	// takes ownership of a buffer allocated with malloc, as returned by nc_reply_dump
+	explicit NetconfReply(char* buffer);
+	explicit NetconfReply(std::string buffer);
+	NetconfReply(NetconfReply && other);
+	NetconfReply & operator=(NetconfReply && other);
+	~NetconfReply();
+
+	NetconfReply(const NetconfReply &) = delete;
+	NetconfReply & operator=(const NetconfReply &) = delete;
+
+	const char* c_str() const;
+	std::size_t size() const;
+	std::string str() const;
+	bool contains(const char* text) const;
+
+	// Returns the content of the <data> element, or nullptr if the reply has none.
+	// The reply is cut at the closing </data> tag, so c_str() no longer shows the whole reply.
+	const char* data_section();
+
+private:
+	void reset();
+
+private:
+	char* buffer;
+	std::size_t length;
+	std::string storage;
+	bool allocated;
+};
+
+}
+
+#endif /* _YDK_NETCONF_REPLY_H_ */
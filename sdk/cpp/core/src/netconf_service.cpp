@@ -35,10 +35,22 @@ namespace ydk {
 std::string get_data_payload(Entity& entity, path::RootSchemaNode& root_schema);
 
 NetconfService::NetconfService()
+	: executor(nullptr)
 {
 	BOOST_LOG_TRIVIAL(debug) << "ydk.services.NetconfService";
 }
 
+NetconfService::NetconfService(TaskExecutor & executor)
+	: executor(&executor)
+{
+	BOOST_LOG_TRIVIAL(debug) << "ydk.services.NetconfService";
+}
+
+TaskExecutor & NetconfService::get_executor()
+{
+	return executor != nullptr ? *executor : get_default_executor();
+}
+
 //cancel_commit
 bool NetconfService::cancel_commit(NetconfServiceProvider & provider, std::string persist_id)
 {
@@ -543,4 +555,53 @@ std::string get_data_payload(Entity & entity, path::RootSchemaNode & root_schema
 	return codec.encode(data_node, ydk::path::CodecService::Format::XML, true);
 }
 
+//async variants
+std::future<bool> NetconfService::commit_async(NetconfServiceProvider & provider, std::string confirmed,
+	std::string confirm_timeout, std::string persist, std::string persist_id)
+{
+	return submit(get_executor(), [=, &provider]() {
+		return commit(provider, confirmed, confirm_timeout, persist, persist_id);
+	});
+}
+
+void NetconfService::commit_async(NetconfServiceProvider & provider, std::function<void(std::future<bool>)> callback,
+	std::string confirmed, std::string confirm_timeout, std::string persist, std::string persist_id)
+{
+	submit(get_executor(), [=, &provider]() {
+		return commit(provider, confirmed, confirm_timeout, persist, persist_id);
+	}, callback);
+}
+
+std::future<bool> NetconfService::edit_config_async(NetconfServiceProvider & provider, DataStore target, Entity& config,
+	std::string default_operation, std::string test_option, std::string error_option)
+{
+	return submit(get_executor(), [=, &provider, &config]() {
+		return edit_config(provider, target, config, default_operation, test_option, error_option);
+	});
+}
+
+void NetconfService::edit_config_async(NetconfServiceProvider & provider, DataStore target, Entity& config,
+	std::function<void(std::future<bool>)> callback,
+	std::string default_operation, std::string test_option, std::string error_option)
+{
+	submit(get_executor(), [=, &provider, &config]() {
+		return edit_config(provider, target, config, default_operation, test_option, error_option);
+	}, callback);
+}
+
+std::future<bool> NetconfService::get_config_async(NetconfServiceProvider & provider, DataStore source, Entity& filter)
+{
+	return submit(get_executor(), [=, &provider, &filter]() {
+		return get_config(provider, source, filter);
+	});
+}
+
+void NetconfService::get_config_async(NetconfServiceProvider & provider, DataStore source, Entity& filter,
+	std::function<void(std::future<bool>)> callback)
+{
+	submit(get_executor(), [=, &provider, &filter]() {
+		return get_config(provider, source, filter);
+	}, callback);
+}
+
 }
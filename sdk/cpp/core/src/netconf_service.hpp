@@ -28,11 +28,14 @@
 #ifndef NETCONF_SERVICE_HPP
 #define NETCONF_SERVICE_HPP
 
+#include <functional>
+#include <future>
 #include <map>
 #include <memory>
 #include <string>
 #include "service.hpp"
 #include "netconf_provider.hpp"
+#include "task_executor.hpp"
 #include "types.hpp"
 
 namespace ydk
@@ -58,6 +61,7 @@ class NetconfService : public Service
 {
 	public:
 		NetconfService();
+		explicit NetconfService(TaskExecutor & executor);
 		bool cancel_commit(NetconfServiceProvider & provider, std::string persist_id = "");
 		bool close_session(NetconfServiceProvider & provider);
 		bool commit(NetconfServiceProvider & provider, std::string confirmed = "", 
@@ -75,6 +79,28 @@ class NetconfService : public Service
 		bool unlock(NetconfServiceProvider & provider, DataStore target);
 		bool validate(NetconfServiceProvider & provider, DataStore source);
 		bool validate(NetconfServiceProvider & provider, Entity& source);
+
+		// Asynchronous variants run on the service's executor. The provider and the
+		// entity must outlive the returned future or the call of the callback.
+		std::future<bool> commit_async(NetconfServiceProvider & provider, std::string confirmed = "",
+			std::string confirm_timeout = "", std::string persist = "", std::string persist_id = "");
+		void commit_async(NetconfServiceProvider & provider, std::function<void(std::future<bool>)> callback,
+			std::string confirmed = "", std::string confirm_timeout = "", std::string persist = "", std::string persist_id = "");
+		std::future<bool> edit_config_async(NetconfServiceProvider & provider, DataStore target, Entity& config,
+			std::string default_operation = "", std::string test_option = "", std::string error_option = "");
+		void edit_config_async(NetconfServiceProvider & provider, DataStore target, Entity& config,
+			std::function<void(std::future<bool>)> callback,
+			std::string default_operation = "", std::string test_option = "", std::string error_option = "");
+		std::future<bool> get_config_async(NetconfServiceProvider & provider, DataStore source, Entity& filter);
+		void get_config_async(NetconfServiceProvider & provider, DataStore source, Entity& filter,
+			std::function<void(std::future<bool>)> callback);
+
+	private:
+		TaskExecutor & get_executor();
+
+	private:
+		// null for the services using the default executor, which the first asynchronous call starts
+		TaskExecutor* executor;
 };
 
 }
@@ -0,0 +1,276 @@
+/// YANG Development Kit
+// Copyright 2016 Cisco Systems. All rights reserved
+//
+////////////////////////////////////////////////////////////////
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+//
+//////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+
+#include <boost/log/trivial.hpp>
+
+#include "netconf_client.hpp"
+#include "netconf_session_pool.hpp"
+#include "netconf_transport.hpp"
+
+using namespace std;
+
+namespace ydk
+{
+NetconfSessionPool::Session::Session(NetconfSessionPool & pool, unique_ptr<NetconfClient> client)
+	: pool(&pool), client(move(client))
+{
+}
+
+NetconfSessionPool::Session::Session(Session && other)
+	: pool(other.pool), client(move(other.client))
+{
+}
+
+NetconfSessionPool::Session::~Session()
+{
+	if(client)
+	{
+		pool->release(move(client));
+	}
+}
+
+NetconfClient & NetconfSessionPool::Session::operator*() const
+{
+	return *client;
+}
+
+NetconfClient * NetconfSessionPool::Session::operator->() const
+{
+	return client.get();
+}
+
+NetconfSessionPool::NetconfSessionPool(string username, string password,
+		string address, int port, const NetconfSessionPoolOptions & options)
+	: NetconfSessionPool(SshTransport{username, password, address, port}, options)
+{
+}
+
+NetconfSessionPool::NetconfSessionPool(const NetconfTransport & transport, const NetconfSessionPoolOptions & options)
+	: transport(transport.clone()), options(options), open_sessions(0)
+{
+	this->options.min_size = max<size_t>(this->options.min_size, 1);
+	this->options.max_size = max(this->options.max_size, this->options.min_size);
+
+	for(size_t i = 0; i < this->options.min_size; ++i)
+	{
+		auto client = create_session();
+		if(capabilities.empty())
+		{
+			capabilities = client->get_capabilities();
+		}
+		idle_sessions.push_back({move(client), chrono::steady_clock::now()});
+		++open_sessions;
+	}
+	BOOST_LOG_TRIVIAL(debug) << "Opened " << open_sessions << " session(s) to " << get_hostname_port();
+}
+
+NetconfSessionPool::~NetconfSessionPool()
+{
+}
+
+NetconfSessionPool::Session NetconfSessionPool::checkout()
+{
+	vector<unique_ptr<NetconfClient>> dead;
+	unique_lock<mutex> lock{pool_mutex};
+	while(true)
+	{
+		while(!idle_sessions.empty())
+		{
+			IdleSession idle = move(idle_sessions.back());
+			idle_sessions.pop_back();
+
+			// the session may be probed, which takes a round trip, so the lock is released
+			lock.unlock();
+			if(is_usable(idle))
+			{
+				return Session{*this, move(idle.client)};
+			}
+			BOOST_LOG_TRIVIAL(debug) << "Discarding dead session to " << get_hostname_port();
+			dead.push_back(move(idle.client));
+			lock.lock();
+			--open_sessions;
+		}
+
+		if(open_sessions < options.max_size)
+		{
+			++open_sessions;
+			lock.unlock();
+			try
+			{
+				return Session{*this, create_session()};
+			}
+			catch(...)
+			{
+				lock.lock();
+				--open_sessions;
+				available.notify_one();
+				throw;
+			}
+		}
+
+		available.wait(lock);
+	}
+}
+
+void NetconfSessionPool::evict_idle()
+{
+	vector<unique_ptr<NetconfClient>> expired;
+	lock_guard<mutex> lock{pool_mutex};
+	take_expired(expired);
+}
+
+void NetconfSessionPool::keepalive()
+{
+	if(options.keepalive_interval.count() == 0)
+	{
+		return;
+	}
+
+	vector<IdleSession> due;
+	{
+		lock_guard<mutex> lock{pool_mutex};
+		auto now = chrono::steady_clock::now();
+		for(auto it = idle_sessions.begin(); it != idle_sessions.end();)
+		{
+			if(now - it->idle_since >= options.keepalive_interval)
+			{
+				due.push_back(move(*it));
+				it = idle_sessions.erase(it);
+			}
+			else
+			{
+				++it;
+			}
+		}
+	}
+
+	vector<unique_ptr<NetconfClient>> dead;
+	for(auto & idle : due)
+	{
+		if(!is_usable(idle))
+		{
+			BOOST_LOG_TRIVIAL(debug) << "Discarding dead session to " << get_hostname_port();
+			dead.push_back(move(idle.client));
+			continue;
+		}
+		release(move(idle.client));
+	}
+
+	if(!dead.empty())
+	{
+		lock_guard<mutex> lock{pool_mutex};
+		open_sessions -= dead.size();
+		available.notify_all();
+	}
+}
+
+unique_ptr<NetconfClient> NetconfSessionPool::open_session()
+{
+	return create_session();
+}
+
+vector<string> NetconfSessionPool::get_capabilities() const
+{
+	return capabilities;
+}
+
+string NetconfSessionPool::get_hostname_port() const
+{
+	return transport->get_hostname_port();
+}
+
+size_t NetconfSessionPool::size()
+{
+	lock_guard<mutex> lock{pool_mutex};
+	return open_sessions;
+}
+
+unique_ptr<NetconfClient> NetconfSessionPool::create_session()
+{
+	auto client = make_unique<NetconfClient>(transport->clone(), 0);
+	client->connect();
+	if(capabilities.empty())
+	{
+		return client;
+	}
+
+	auto expected = capabilities;
+	auto announced = client->get_capabilities();
+	sort(expected.begin(), expected.end());
+	sort(announced.begin(), announced.end());
+	if(expected != announced)
+	{
+		BOOST_LOG_TRIVIAL(error) << "Capabilities of " << get_hostname_port() << " changed since the pool was opened";
+		BOOST_THROW_EXCEPTION(YCPPIllegalStateError{"Capabilities of " + get_hostname_port() + " changed, the provider has to be recreated"});
+	}
+	return client;
+}
+
+bool NetconfSessionPool::is_usable(IdleSession & idle)
+{
+	if(!idle.client->is_connected())
+	{
+		return false;
+	}
+
+	if(options.keepalive_interval.count() == 0
+			|| chrono::steady_clock::now() - idle.idle_since < options.keepalive_interval)
+	{
+		return true;
+	}
+	return idle.client->is_alive();
+}
+
+void NetconfSessionPool::release(unique_ptr<NetconfClient> client)
+{
+	// sessions are closed outside the lock, after the lock guard is released
+	vector<unique_ptr<NetconfClient>> expired;
+	lock_guard<mutex> lock{pool_mutex};
+	if(client->is_connected())
+	{
+		idle_sessions.push_back({move(client), chrono::steady_clock::now()});
+	}
+	else
+	{
+		BOOST_LOG_TRIVIAL(debug) << "Discarding dead session to " << get_hostname_port();
+		expired.push_back(move(client));
+		--open_sessions;
+	}
+	take_expired(expired);
+	available.notify_one();
+}
+
+void NetconfSessionPool::take_expired(vector<unique_ptr<NetconfClient>> & expired)
+{
+	auto now = chrono::steady_clock::now();
+	while(open_sessions > options.min_size && !idle_sessions.empty()
+			&& now - idle_sessions.front().idle_since >= options.idle_timeout)
+	{
+		expired.push_back(move(idle_sessions.front().client));
+		idle_sessions.pop_front();
+		--open_sessions;
+	}
+}
+}
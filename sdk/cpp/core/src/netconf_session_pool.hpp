@@ -0,0 +1,115 @@
+/*  ----------------------------------------------------------------
+ Copyright 2016 Cisco Systems
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+------------------------------------------------------------------*/
+
+#ifndef _NETCONF_SESSION_POOL_H_
+#define _NETCONF_SESSION_POOL_H_
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace ydk {
+
+class NetconfClient;
+class NetconfTransport;
+
+struct NetconfSessionPoolOptions
+{
+	// number of sessions kept open even when idle
+	std::size_t min_size = 1;
+	// upper bound on sessions opened to the device
+	std::size_t max_size = 1;
+	// idle sessions above min_size are closed after this long
+	std::chrono::seconds idle_timeout = std::chrono::seconds{300};
+	// sessions idle for longer are probed before being handed out and by keepalive(),
+	// zero turns probing off
+	std::chrono::seconds keepalive_interval = std::chrono::seconds{60};
+};
+
+// A pool of NETCONF sessions to a single device. Sessions are checked out for the
+// duration of one operation and returned to the pool when the lease goes out of scope.
+// Sessions found to be dead on checkout or return are discarded and replaced on demand.
+// A replacement session has to announce the capabilities the pool was opened with, as
+// the schema built from them is reused for it.
+class NetconfSessionPool
+{
+public:
+	class Session
+	{
+	public:
+		Session(NetconfSessionPool & pool, std::unique_ptr<NetconfClient> client);
+		Session(Session && other);
+		~Session();
+
+		NetconfClient & operator*() const;
+		NetconfClient * operator->() const;
+
+	private:
+		NetconfSessionPool * pool;
+		std::unique_ptr<NetconfClient> client;
+	};
+
+public:
+	NetconfSessionPool(std::string username, std::string password,
+			std::string address, int port, const NetconfSessionPoolOptions & options);
+	// sessions are connected through clones of the given transport
+	NetconfSessionPool(const NetconfTransport & transport, const NetconfSessionPoolOptions & options);
+	~NetconfSessionPool();
+
+	// blocks until a session is available if max_size sessions are checked out
+	Session checkout();
+	void evict_idle();
+	// probes the sessions idle for longer than keepalive_interval and discards dead ones,
+	// meant to be called periodically to keep connections through firewalls and NATs open
+	void keepalive();
+	// a connected session which does not belong to the pool, for exclusive long lived use
+	// such as receiving notifications
+	std::unique_ptr<NetconfClient> open_session();
+
+	std::vector<std::string> get_capabilities() const;
+	std::string get_hostname_port() const;
+	std::size_t size();
+
+private:
+	struct IdleSession
+	{
+		std::unique_ptr<NetconfClient> client;
+		std::chrono::steady_clock::time_point idle_since;
+	};
+
+	std::unique_ptr<NetconfClient> create_session();
+	bool is_usable(IdleSession & idle);
+	void release(std::unique_ptr<NetconfClient> client);
+	void take_expired(std::vector<std::unique_ptr<NetconfClient>> & expired);
+
+private:
+	std::unique_ptr<NetconfTransport> transport;
+	NetconfSessionPoolOptions options;
+
+	std::mutex pool_mutex;
+	std::condition_variable available;
+	std::deque<IdleSession> idle_sessions;
+	std::size_t open_sessions;
+
+	std::vector<std::string> capabilities;
+};
+}
+
+#endif /*_NETCONF_SESSION_POOL_H_*/
@@ -0,0 +1,244 @@
+/// YANG Development Kit
+// Copyright 2016 Cisco Systems. All rights reserved
+//
+////////////////////////////////////////////////////////////////
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+//
+//////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include <cmath>
+
+#include "netconf_stats.hpp"
+
+using namespace std;
+
+namespace ydk
+{
+const char* to_string(RpcPhase phase)
+{
+	switch(phase)
+	{
+		case RpcPhase::build:
+			return "build";
+		case RpcPhase::send:
+			return "send";
+		case RpcPhase::wait:
+			return "wait";
+		case RpcPhase::dump:
+			return "dump";
+		case RpcPhase::decode:
+			return "decode";
+		case RpcPhase::populate:
+			return "populate";
+	}
+	return "unknown";
+}
+
+const size_t LatencyHistogram::BUCKETS;
+
+LatencyHistogram::LatencyHistogram()
+	: samples(0), max_value(0), total_value(0)
+{
+	buckets.fill(0);
+}
+
+void LatencyHistogram::record(chrono::microseconds value)
+{
+	uint64_t us = value.count() < 0 ? 0 : static_cast<uint64_t>(value.count());
+	++buckets[bucket_of(us)];
+	++samples;
+	max_value = std::max(max_value, us);
+	total_value += us;
+}
+
+chrono::microseconds LatencyHistogram::percentile(double fraction) const
+{
+	if(samples == 0)
+	{
+		return chrono::microseconds{0};
+	}
+
+	uint64_t rank = static_cast<uint64_t>(ceil(fraction * samples));
+	rank = std::min(std::max<uint64_t>(rank, 1), samples);
+
+	uint64_t seen = 0;
+	for(size_t bucket = 0; bucket < BUCKETS; ++bucket)
+	{
+		seen += buckets[bucket];
+		if(seen >= rank)
+		{
+			return chrono::microseconds{static_cast<chrono::microseconds::rep>(std::min(upper_bound_of(bucket), max_value))};
+		}
+	}
+	return max();
+}
+
+uint64_t LatencyHistogram::count() const
+{
+	return samples;
+}
+
+chrono::microseconds LatencyHistogram::max() const
+{
+	return chrono::microseconds{static_cast<chrono::microseconds::rep>(max_value)};
+}
+
+chrono::microseconds LatencyHistogram::total() const
+{
+	return chrono::microseconds{static_cast<chrono::microseconds::rep>(total_value)};
+}
+
+size_t LatencyHistogram::bucket_of(uint64_t value)
+{
+	if(value < 16)
+	{
+		return static_cast<size_t>(value);
+	}
+
+	size_t exponent = 63 - __builtin_clzll(value);
+	size_t bucket = 16 + (exponent - 4) * 8 + ((value >> (exponent - 3)) & 7);
+	return std::min(bucket, BUCKETS - 1);
+}
+
+uint64_t LatencyHistogram::upper_bound_of(size_t bucket)
+{
+	if(bucket < 16)
+	{
+		return bucket;
+	}
+
+	size_t exponent = (bucket - 16) / 8 + 4;
+	uint64_t sub_bucket = (bucket - 16) % 8;
+	return ((9 + sub_bucket) << (exponent - 3)) - 1;
+}
+
+NetconfStats::NetconfStats()
+	: enabled(false)
+{
+}
+
+void NetconfStats::record(const string & rpc, RpcPhase phase, chrono::steady_clock::duration elapsed,
+		size_t request_bytes, size_t reply_bytes)
+{
+	if(!enabled)
+	{
+		return;
+	}
+
+	auto us = chrono::duration_cast<chrono::microseconds>(elapsed);
+	lock_guard<mutex> lock{stats_mutex};
+	PhaseData & phase_data = data[rpc][phase];
+	phase_data.latency.record(us);
+	phase_data.request_bytes += request_bytes;
+	phase_data.reply_bytes += reply_bytes;
+}
+
+NetconfStatsSnapshot NetconfStats::snapshot() const
+{
+	NetconfStatsSnapshot snapshot{};
+	lock_guard<mutex> lock{stats_mutex};
+	for(auto & rpc : data)
+	{
+		for(auto & phase : rpc.second)
+		{
+			RpcPhaseStats & stats = snapshot[rpc.first][phase.first];
+			const LatencyHistogram & latency = phase.second.latency;
+			stats.count = latency.count();
+			stats.request_bytes = phase.second.request_bytes;
+			stats.reply_bytes = phase.second.reply_bytes;
+			stats.total = latency.total();
+			stats.p50 = latency.percentile(0.5);
+			stats.p99 = latency.percentile(0.99);
+			stats.max = latency.max();
+		}
+	}
+	return snapshot;
+}
+
+void NetconfStats::reset()
+{
+	lock_guard<mutex> lock{stats_mutex};
+	data.clear();
+}
+
+void NetconfStats::set_enabled(bool enabled)
+{
+	this->enabled = enabled;
+}
+
+bool NetconfStats::is_enabled() const
+{
+	return enabled;
+}
+
+RpcPhaseTimer::RpcPhaseTimer(NetconfStats * stats, const string & rpc, RpcPhase phase)
+	: stats(stats != nullptr && stats->is_enabled() ? stats : nullptr),
+	  phase(phase), request_bytes(0), reply_bytes(0)
+{
+	if(this->stats != nullptr)
+	{
+		this->rpc = rpc;
+		start = chrono::steady_clock::now();
+	}
+}
+
+RpcPhaseTimer::~RpcPhaseTimer()
+{
+	if(stats != nullptr)
+	{
+		stats->record(rpc, phase, chrono::steady_clock::now() - start, request_bytes, reply_bytes);
+	}
+}
+
+void RpcPhaseTimer::set_bytes(size_t request_bytes, size_t reply_bytes)
+{
+	this->request_bytes = request_bytes;
+	this->reply_bytes = reply_bytes;
+}
+
+string get_rpc_name(const string & payload)
+{
+	auto rpc_start = payload.find("<rpc");
+	if(rpc_start == string::npos)
+	{
+		return "rpc";
+	}
+
+	auto name_start = payload.find('<', payload.find('>', rpc_start));
+	if(name_start == string::npos)
+	{
+		return "rpc";
+	}
+	++name_start;
+
+	auto name_end = payload.find_first_of(" \t\r\n/>", name_start);
+	if(name_end == string::npos)
+	{
+		return "rpc";
+	}
+
+	auto prefix_end = payload.find(':', name_start);
+	if(prefix_end != string::npos && prefix_end < name_end)
+	{
+		name_start = prefix_end + 1;
+	}
+	return payload.substr(name_start, name_end - name_start);
+}
+
+}
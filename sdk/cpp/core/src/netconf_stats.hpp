@@ -0,0 +1,147 @@
+/*  ----------------------------------------------------------------
+ Copyright 2016 Cisco Systems
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+------------------------------------------------------------------*/
+
+#ifndef _NETCONF_STATS_H_
+#define _NETCONF_STATS_H_
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+
+namespace ydk {
+
+// The stages an RPC goes through, in order
+enum class RpcPhase {
+	// building the libnetconf rpc from the payload
+	build,
+	// writing the rpc to the session
+	send,
+	// from the rpc being sent until its reply is collected
+	wait,
+	// dumping the received reply to text
+	dump,
+	// decoding the reply data to a DataNode tree
+	decode,
+	// populating the entities from the DataNode tree
+	populate
+};
+
+const char* to_string(RpcPhase phase);
+
+// Latency distribution of one phase of one kind of RPC. The percentiles are the upper
+// bounds of the histogram buckets they fall in, which are at most 1/8 wider than the
+// values they hold.
+struct RpcPhaseStats
+{
+	std::uint64_t count = 0;
+	std::uint64_t request_bytes = 0;
+	std::uint64_t reply_bytes = 0;
+	std::chrono::microseconds total{0};
+	std::chrono::microseconds p50{0};
+	std::chrono::microseconds p99{0};
+	std::chrono::microseconds max{0};
+};
+
+// rpc name (e.g. "get-config") -> phase -> stats
+typedef std::map<std::string, std::map<RpcPhase, RpcPhaseStats>> NetconfStatsSnapshot;
+
+// Fixed size log-linear histogram of microsecond latencies: values below 16us get a bucket
+// each, every power of two above that is split into 8 buckets.
+class LatencyHistogram
+{
+public:
+	LatencyHistogram();
+
+	void record(std::chrono::microseconds value);
+	std::chrono::microseconds percentile(double fraction) const;
+	std::uint64_t count() const;
+	std::chrono::microseconds max() const;
+	std::chrono::microseconds total() const;
+
+private:
+	static const std::size_t BUCKETS = 16 + 8 * 36;
+
+	static std::size_t bucket_of(std::uint64_t value);
+	static std::uint64_t upper_bound_of(std::size_t bucket);
+
+private:
+	std::array<std::uint64_t, BUCKETS> buckets;
+	std::uint64_t samples;
+	std::uint64_t max_value;
+	std::uint64_t total_value;
+};
+
+// Collects the time spent in each phase of the RPCs executed through a provider, together
+// with the size of the requests and replies. Safe to use from several threads.
+class NetconfStats
+{
+public:
+	NetconfStats();
+
+	void record(const std::string & rpc, RpcPhase phase, std::chrono::steady_clock::duration elapsed,
+			std::size_t request_bytes = 0, std::size_t reply_bytes = 0);
+
+	NetconfStatsSnapshot snapshot() const;
+	void reset();
+
+	// recording is off by default, the rpcs are only split into timed phases once it is on
+	void set_enabled(bool enabled);
+	bool is_enabled() const;
+
+private:
+	struct PhaseData
+	{
+		LatencyHistogram latency;
+		std::uint64_t request_bytes = 0;
+		std::uint64_t reply_bytes = 0;
+	};
+
+	mutable std::mutex stats_mutex;
+	std::map<std::string, std::map<RpcPhase, PhaseData>> data;
+	std::atomic<bool> enabled;
+};
+
+// Times a phase from construction until it goes out of scope; does nothing without stats
+class RpcPhaseTimer
+{
+public:
+	RpcPhaseTimer(NetconfStats * stats, const std::string & rpc, RpcPhase phase);
+	~RpcPhaseTimer();
+
+	RpcPhaseTimer(const RpcPhaseTimer&) = delete;
+	RpcPhaseTimer& operator=(const RpcPhaseTimer&) = delete;
+
+	void set_bytes(std::size_t request_bytes, std::size_t reply_bytes);
+
+private:
+	NetconfStats * stats;
+	std::string rpc;
+	RpcPhase phase;
+	std::chrono::steady_clock::time_point start;
+	std::size_t request_bytes;
+	std::size_t reply_bytes;
+};
+
+// name of the operation a netconf <rpc> payload carries, e.g. "edit-config"
+std::string get_rpc_name(const std::string & payload);
+
+}
+
+#endif /*_NETCONF_STATS_H_*/
@@ -0,0 +1,341 @@
+/// YANG Development Kit
+// Copyright 2016 Cisco Systems. All rights reserved
+//
+////////////////////////////////////////////////////////////////
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+//
+//////////////////////////////////////////////////////////////////
+
+#include <cstdlib>
+#include <fcntl.h>
+#include <mutex>
+#include <signal.h>
+#include <stdio.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <libnetconf.h>
+#include <libnetconf_ssh.h>
+#ifdef YDK_NETCONF_TLS
+#include <libnetconf_tls.h>
+#endif
+#include <boost/log/trivial.hpp>
+
+#include "errors.hpp"
+#include "netconf_transport.hpp"
+
+using namespace std;
+
+namespace ydk
+{
+static void register_ssh_callbacks();
+static char* clb_set_password(const char* username, const char* hostname);
+static int clb_ssh_host_authenticity_check(const char *hostname, ssh_session session);
+#ifdef YDK_NETCONF_TLS
+static const char* get_optional(const string & value);
+#endif
+
+// libnetconf asks for the password through a process wide callback which carries no
+// session context. It is called on the thread running nc_session_connect, so the transport
+// being connected on each thread is where the callback finds the password.
+static thread_local const string* connecting_password = nullptr;
+
+struct ConnectingPassword
+{
+	ConnectingPassword(const string & password)
+	{
+		connecting_password = &password;
+	}
+
+	~ConnectingPassword()
+	{
+		connecting_password = nullptr;
+	}
+};
+
+NetconfTransport::~NetconfTransport()
+{
+}
+
+void NetconfTransport::disconnect()
+{
+}
+
+SshTransport::SshTransport(string username, string password, string address, int port)
+	: username(username), password(password), address(address), port(port)
+{
+	static once_flag callbacks_registered;
+	call_once(callbacks_registered, register_ssh_callbacks);
+}
+
+struct nc_session* SshTransport::connect()
+{
+	ConnectingPassword connecting{password};
+	return nc_session_connect(address.c_str(), port, username.c_str(), NULL);
+}
+
+unique_ptr<NetconfTransport> SshTransport::clone() const
+{
+	return unique_ptr<NetconfTransport>{new SshTransport{username, password, address, port}};
+}
+
+string SshTransport::get_hostname() const
+{
+	return address;
+}
+
+string SshTransport::get_hostname_port() const
+{
+	return address + ":" + to_string(port);
+}
+
+TlsTransport::TlsTransport(string username, string address, int port, TlsCredentials credentials)
+	: username(username), address(address), port(port), credentials(credentials)
+{
+}
+
+struct nc_session* TlsTransport::connect()
+{
+#ifdef YDK_NETCONF_TLS
+	// libnetconf keeps the transport and the TLS context per thread
+	if(nc_tls_init(get_optional(credentials.certificate), get_optional(credentials.private_key),
+			get_optional(credentials.ca_file), get_optional(credentials.ca_path),
+			get_optional(credentials.crl_file), get_optional(credentials.crl_path)) != EXIT_SUCCESS)
+	{
+		BOOST_LOG_TRIVIAL(debug) << "TLS context already initialized on this thread";
+	}
+
+	nc_session_transport(NC_TRANSPORT_TLS);
+	struct nc_session* session = nc_session_connect(address.c_str(), port, username.c_str(), NULL);
+	nc_session_transport(NC_TRANSPORT_SSH);
+	return session;
+#else
+	BOOST_LOG_TRIVIAL(error) << "NETCONF over TLS is not supported by this build";
+	BOOST_THROW_EXCEPTION(YCPPOperationNotSupportedError{"NETCONF over TLS is not supported by this build, enable ENABLE_NETCONF_TLS"});
+#endif
+}
+
+unique_ptr<NetconfTransport> TlsTransport::clone() const
+{
+	return unique_ptr<NetconfTransport>{new TlsTransport{username, address, port, credentials}};
+}
+
+string TlsTransport::get_hostname() const
+{
+	return address;
+}
+
+string TlsTransport::get_hostname_port() const
+{
+	return address + ":" + to_string(port);
+}
+
+UnixSocketTransport::UnixSocketTransport(string username, string socket_path)
+	: username(username), socket_path(socket_path), fd(-1)
+{
+}
+
+struct nc_session* UnixSocketTransport::connect()
+{
+	struct sockaddr_un address{};
+	if(socket_path.size() >= sizeof(address.sun_path))
+	{
+		BOOST_LOG_TRIVIAL(error) << "Socket path too long: " << socket_path;
+		BOOST_THROW_EXCEPTION(YCPPInvalidArgumentError{"Socket path too long: " + socket_path});
+	}
+	address.sun_family = AF_UNIX;
+	snprintf(address.sun_path, sizeof(address.sun_path), "%s", socket_path.c_str());
+
+	fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+	if(fd == -1 || ::connect(fd, reinterpret_cast<struct sockaddr*>(&address), sizeof(address)) == -1)
+	{
+		BOOST_LOG_TRIVIAL(error) << "Could not connect to socket " << socket_path;
+		disconnect();
+		return NULL;
+	}
+
+	// libnetconf does not take ownership of the descriptors
+	struct nc_session* session = nc_session_connect_inout(fd, fd, NULL, socket_path.c_str(), "0",
+			username.c_str(), NC_TRANSPORT_SSH);
+	if(session == NULL)
+	{
+		disconnect();
+	}
+	return session;
+}
+
+void UnixSocketTransport::disconnect()
+{
+	if(fd != -1)
+	{
+		close(fd);
+		fd = -1;
+	}
+}
+
+unique_ptr<NetconfTransport> UnixSocketTransport::clone() const
+{
+	return unique_ptr<NetconfTransport>{new UnixSocketTransport{username, socket_path}};
+}
+
+string UnixSocketTransport::get_hostname() const
+{
+	return socket_path;
+}
+
+string UnixSocketTransport::get_hostname_port() const
+{
+	return "unix:" + socket_path;
+}
+
+StdioTransport::StdioTransport(string username, vector<string> command)
+	: username(username), command(command), pid(-1), fd_in(-1), fd_out(-1)
+{
+	if(command.empty())
+	{
+		BOOST_LOG_TRIVIAL(error) << "No server command given";
+		BOOST_THROW_EXCEPTION(YCPPInvalidArgumentError{"No server command given"});
+	}
+}
+
+struct nc_session* StdioTransport::connect()
+{
+	int to_server[2];
+	int from_server[2];
+	if(pipe2(to_server, O_CLOEXEC) == -1)
+	{
+		BOOST_LOG_TRIVIAL(error) << "Could not create pipe to " << command[0];
+		return NULL;
+	}
+	if(pipe2(from_server, O_CLOEXEC) == -1)
+	{
+		close(to_server[0]);
+		close(to_server[1]);
+		BOOST_LOG_TRIVIAL(error) << "Could not create pipe from " << command[0];
+		return NULL;
+	}
+
+	// the argument vector is built before forking, the child must not allocate
+	vector<char*> argv;
+	for(auto & argument : command)
+	{
+		argv.push_back(const_cast<char*>(argument.c_str()));
+	}
+	argv.push_back(NULL);
+
+	pid = fork();
+	if(pid == 0)
+	{
+		dup2(to_server[0], STDIN_FILENO);
+		dup2(from_server[1], STDOUT_FILENO);
+		execvp(argv[0], argv.data());
+		_exit(127);
+	}
+
+	close(to_server[0]);
+	close(from_server[1]);
+	fd_out = to_server[1];
+	fd_in = from_server[0];
+	if(pid == -1)
+	{
+		BOOST_LOG_TRIVIAL(error) << "Could not start " << command[0];
+		disconnect();
+		return NULL;
+	}
+
+	struct nc_session* session = nc_session_connect_inout(fd_in, fd_out, NULL, command[0].c_str(), "0",
+			username.c_str(), NC_TRANSPORT_SSH);
+	if(session == NULL)
+	{
+		disconnect();
+	}
+	return session;
+}
+
+void StdioTransport::disconnect()
+{
+	if(fd_out != -1)
+	{
+		close(fd_out);
+		fd_out = -1;
+	}
+	if(fd_in != -1)
+	{
+		close(fd_in);
+		fd_in = -1;
+	}
+	if(pid > 0)
+	{
+		kill(pid, SIGTERM);
+		waitpid(pid, NULL, 0);
+		pid = -1;
+	}
+}
+
+unique_ptr<NetconfTransport> StdioTransport::clone() const
+{
+	return unique_ptr<NetconfTransport>{new StdioTransport{username, command}};
+}
+
+string StdioTransport::get_hostname() const
+{
+	return "localhost";
+}
+
+string StdioTransport::get_hostname_port() const
+{
+	return "stdio:" + command[0];
+}
+
+static void register_ssh_callbacks()
+{
+	nc_callback_sshauth_password(clb_set_password);
+	nc_callback_ssh_host_authenticity_check(clb_ssh_host_authenticity_check);
+}
+
+static char* clb_set_password(const char* user_name, const char* host_name)
+{
+	if(connecting_password == nullptr)
+	{
+		BOOST_LOG_TRIVIAL(error) << "No password for " << user_name << "@" << host_name << ", no session is being connected on this thread";
+		return NULL;
+	}
+
+	const string & password_string = *connecting_password;
+	char* password_buffer = (char*) malloc(
+			sizeof(char) * (password_string.size() + 1));
+	snprintf(password_buffer, password_string.size() + 1, "%s",
+			password_string.c_str());
+
+	return password_buffer;
+}
+
+static int clb_ssh_host_authenticity_check(const char *hostname, ssh_session session)
+{
+	return EXIT_SUCCESS;
+}
+
+#ifdef YDK_NETCONF_TLS
+static const char* get_optional(const string & value)
+{
+	return value.empty() ? NULL : value.c_str();
+}
+#endif
+}
@@ -0,0 +1,141 @@
+/*  ----------------------------------------------------------------
+ Copyright 2016 Cisco Systems
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+------------------------------------------------------------------*/
+
+#ifndef _NETCONF_TRANSPORT_H_
+#define _NETCONF_TRANSPORT_H_
+
+#include <memory>
+#include <string>
+#include <sys/types.h>
+#include <vector>
+
+struct nc_session;
+
+namespace ydk {
+
+// Establishes the connection a NETCONF session runs over. connect opens the connection
+// and performs the hello exchange; disconnect releases whatever the transport holds on
+// to once the session has been freed. A transport connects one session at a time, clone
+// gives an unconnected copy for each further session.
+class NetconfTransport
+{
+public:
+	virtual ~NetconfTransport();
+
+	virtual struct nc_session* connect() = 0;
+	virtual void disconnect();
+	virtual std::unique_ptr<NetconfTransport> clone() const = 0;
+
+	virtual std::string get_hostname() const = 0;
+	virtual std::string get_hostname_port() const = 0;
+};
+
+// NETCONF over SSH, authenticating with a password
+class SshTransport : public NetconfTransport
+{
+public:
+	SshTransport(std::string username, std::string password, std::string address, int port);
+
+	struct nc_session* connect();
+	std::unique_ptr<NetconfTransport> clone() const;
+
+	std::string get_hostname() const;
+	std::string get_hostname_port() const;
+
+private:
+	std::string username;
+	std::string password;
+	std::string address;
+	int port;
+};
+
+struct TlsCredentials
+{
+	// client certificate and its private key
+	std::string certificate;
+	std::string private_key;
+	// trusted certificate authorities, as a file and/or a directory
+	std::string ca_file;
+	std::string ca_path;
+	// certificate revocation lists, optional
+	std::string crl_file;
+	std::string crl_path;
+};
+
+// NETCONF over TLS, authenticating with a client certificate. Requires the library to be
+// built with ENABLE_NETCONF_TLS, connect throws YCPPOperationNotSupportedError otherwise.
+class TlsTransport : public NetconfTransport
+{
+public:
+	TlsTransport(std::string username, std::string address, int port, TlsCredentials credentials);
+
+	struct nc_session* connect();
+	std::unique_ptr<NetconfTransport> clone() const;
+
+	std::string get_hostname() const;
+	std::string get_hostname_port() const;
+
+private:
+	std::string username;
+	std::string address;
+	int port;
+	TlsCredentials credentials;
+};
+
+// Plain NETCONF over a Unix domain socket, for servers running on the same host.
+// Nothing is encrypted and the server is expected to authenticate the peer itself.
+class UnixSocketTransport : public NetconfTransport
+{
+public:
+	UnixSocketTransport(std::string username, std::string socket_path);
+
+	struct nc_session* connect();
+	void disconnect();
+	std::unique_ptr<NetconfTransport> clone() const;
+
+	std::string get_hostname() const;
+	std::string get_hostname_port() const;
+
+private:
+	std::string username;
+	std::string socket_path;
+	int fd;
+};
+
+// Plain NETCONF over the standard input and output of a server process started for the
+// session, e.g. a netconf subsystem binary. The process is terminated on disconnect.
+class StdioTransport : public NetconfTransport
+{
+public:
+	StdioTransport(std::string username, std::vector<std::string> command);
+
+	struct nc_session* connect();
+	void disconnect();
+	std::unique_ptr<NetconfTransport> clone() const;
+
+	std::string get_hostname() const;
+	std::string get_hostname_port() const;
+
+private:
+	std::string username;
+	std::vector<std::string> command;
+	pid_t pid;
+	int fd_in;
+	int fd_out;
+};
+}
+
+#endif /*_NETCONF_TRANSPORT_H_*/
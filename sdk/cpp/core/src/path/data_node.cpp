@@ -22,10 +22,65 @@
 //////////////////////////////////////////////////////////////////
 
 
+#include <cstring>
+
 #include "path_private.hpp"
 #include <boost/log/trivial.hpp>
 
 
+namespace ydk {
+    namespace path {
+        static void append_predicate(const char* name, const char* value, std::string& buffer)
+        {
+            char quote = std::strchr(value, '\'') ? '"' : '\'';
+            buffer+='[';
+            buffer+=name;
+            buffer+="=";
+            buffer+=quote;
+            buffer+=value;
+            buffer+=quote;
+            buffer+=']';
+        }
+
+        // the same segment lyd_path gives for the node, built without allocating
+        static void append_data_segment(const struct lyd_node* node, std::string& buffer)
+        {
+            const struct lys_module* module = lys_node_module(node->schema);
+            if (!node->parent || lys_node_module(node->parent->schema) != module) {
+                buffer+=module->name;
+                buffer+=':';
+            }
+            buffer+=node->schema->name;
+
+            if (node->schema->nodetype == LYS_LIST) {
+                auto list = reinterpret_cast<const struct lys_node_list*>(node->schema);
+                for (uint8_t i = 0; i < list->keys_size; ++i) {
+                    const struct lys_node* key = reinterpret_cast<const struct lys_node*>(list->keys[i]);
+                    for (const struct lyd_node* child = node->child; child; child = child->next) {
+                        if (child->schema == key) {
+                            auto leaf = reinterpret_cast<const struct lyd_node_leaf_list*>(child);
+                            append_predicate(key->name, leaf->value_str ? leaf->value_str : "", buffer);
+                            break;
+                        }
+                    }
+                }
+            } else if (node->schema->nodetype == LYS_LEAFLIST) {
+                auto leaf = reinterpret_cast<const struct lyd_node_leaf_list*>(node);
+                append_predicate(".", leaf->value_str ? leaf->value_str : "", buffer);
+            }
+        }
+
+        static void append_data_path(const struct lyd_node* node, std::string& buffer)
+        {
+            if (node->parent) {
+                append_data_path(node->parent, buffer);
+            }
+            buffer+='/';
+            append_data_segment(node, buffer);
+        }
+    }
+}
+
 ////////////////////////////////////////////////////////////////////////
 /// DataNode
 ////////////////////////////////////////////////////////////////////////
@@ -48,6 +103,38 @@ ydk::path::DataNode::create_filter(const std::string& path)
     return create_filter(path, "");
 }
 
+void
+ydk::path::DataNode::append_path(std::string& buffer) const
+{
+    buffer+=path();
+}
+
+void
+ydk::path::DataNode::append_segment(std::string& buffer) const
+{
+    //the last '/' outside of the predicates, whose values may hold any character
+    std::string node_path = path();
+    std::size_t start = 0;
+    std::size_t depth = 0;
+    char quote = 0;
+    for(std::size_t i = 0; i < node_path.size(); ++i) {
+        char c = node_path[i];
+        if(quote) {
+            if(c == quote)
+                quote = 0;
+        } else if(depth > 0 && (c == '\'' || c == '"')) {
+            quote = c;
+        } else if(c == '[') {
+            ++depth;
+        } else if(c == ']' && depth > 0) {
+            --depth;
+        } else if(c == '/' && depth == 0) {
+            start = i + 1;
+        }
+    }
+    buffer.append(node_path, start, std::string::npos);
+}
+
 ////////////////////////////////////////////////////////////////////////////
 // class ydk::DataNodeImpl
 //////////////////////////////////////////////////////////////////////////
@@ -87,21 +174,29 @@ ydk::path::DataNodeImpl::~DataNodeImpl()
 const ydk::path::SchemaNode*
 ydk::path::DataNodeImpl::schema() const
 {
-    return reinterpret_cast<const SchemaNode*>(m_node->schema->priv);
+    return get_schema_node(m_node->schema);
 }
 
 std::string
 ydk::path::DataNodeImpl::path() const
 {
-    char* path = lyd_path(m_node);
-    if (!path) {
-        return std::string{};
-    }
-    std::string str{path};
-    std::free(path);
+    std::string str{};
+    append_path(str);
     return str;
 }
 
+void
+ydk::path::DataNodeImpl::append_path(std::string& buffer) const
+{
+    append_data_path(m_node, buffer);
+}
+
+void
+ydk::path::DataNodeImpl::append_segment(std::string& buffer) const
+{
+    append_data_segment(m_node, buffer);
+}
+
 
 ydk::path::DataNode*
 ydk::path::DataNodeImpl::create_filter(const std::string& path, const std::string& value)
@@ -125,6 +220,12 @@ ydk::path::DataNodeImpl::create_helper(const std::string& path, const std::strin
     }
 
     std::vector<std::string> segments = segmentalize(path);
+    auto root_schema = dynamic_cast<const RootSchemaNodeImpl*>(schema()->root());
+    if(root_schema)
+    {
+        root_schema->load_modules(path);
+    }
+    SchemaReadLock read_lock{schema()};
 
     DataNodeImpl* dn = this;
 
@@ -296,6 +397,12 @@ ydk::path::DataNodeImpl::find(const std::string& path) const
     if(m_node == nullptr) {
         return results;
     }
+    auto root_schema = dynamic_cast<const RootSchemaNodeImpl*>(schema()->root());
+    if(root_schema)
+    {
+        root_schema->load_modules(path);
+    }
+    SchemaReadLock read_lock{schema()};
     std::string spath{path};
 
     auto s = schema()->statement();
@@ -0,0 +1,345 @@
+/// YANG Development Kit
+// Copyright 2016 Cisco Systems. All rights reserved
+//
+////////////////////////////////////////////////////////////////
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+//
+//////////////////////////////////////////////////////////////////
+
+
+#include "path_private.hpp"
+#include <boost/log/trivial.hpp>
+#include <cctype>
+#include <cstring>
+#include <fstream>
+#include <set>
+
+namespace fs = boost::filesystem;
+
+namespace ydk
+{
+namespace path
+{
+
+static std::set<std::string> get_path_prefixes(const std::string& path);
+static std::set<std::string> get_xml_namespaces(const char* data);
+static std::set<std::string> get_json_member_prefixes(const char* data);
+static std::string read_module_file(const fs::path& search_dir, const Capability& capability);
+static std::map<std::string, std::string> get_import_prefixes(const std::string& text);
+static std::set<std::string> get_augmented_prefixes(const std::string& text);
+
+LazyModuleLoader::LazyModuleLoader(const fs::path& search_dir, const std::vector<Capability>& capabilities)
+    : search_dir{search_dir}, module_files_indexed{false}
+{
+    for(auto & c : capabilities)
+    {
+        if(c.module == "ietf-yang-library")
+            continue;
+        pending.emplace(c.module, c);
+    }
+}
+
+std::set<std::string>
+LazyModuleLoader::pending_in_path(const std::string& path)
+{
+    std::lock_guard<std::mutex> lock{loader_mutex};
+    std::set<std::string> modules;
+    for(auto & prefix : get_path_prefixes(path))
+    {
+        if(pending.find(prefix) != pending.end())
+            modules.insert(prefix);
+    }
+    return modules;
+}
+
+std::set<std::string>
+LazyModuleLoader::pending_in_data(const char* data, bool json)
+{
+    std::lock_guard<std::mutex> lock{loader_mutex};
+    std::set<std::string> modules;
+    if(pending.empty() || data == nullptr)
+        return modules;
+
+    if(json)
+    {
+        for(auto & prefix : get_json_member_prefixes(data))
+        {
+            if(pending.find(prefix) != pending.end())
+                modules.insert(prefix);
+        }
+        return modules;
+    }
+    for(auto & ns : get_xml_namespaces(data))
+    {
+        std::string module = get_namespace_module(ns);
+        if(!module.empty())
+            modules.insert(module);
+    }
+    return modules;
+}
+
+bool
+LazyModuleLoader::load(struct ly_ctx* ctx, const std::set<std::string>& modules)
+{
+    std::lock_guard<std::mutex> lock{loader_mutex};
+    bool loaded = false;
+    for(auto & module : modules)
+        loaded = load_module(ctx, module) || loaded;
+    return loaded;
+}
+
+bool
+LazyModuleLoader::load_module(struct ly_ctx* ctx, const std::string& module_name)
+{
+    auto found = pending.find(module_name);
+    if(found == pending.end())
+        return false;
+    Capability c = found->second;
+    pending.erase(found);
+
+    BOOST_LOG_TRIVIAL(debug) << "Loading module " << c.module << " on first use";
+    auto p = ly_ctx_get_module(ctx, c.module.c_str(), c.revision.empty() ? 0 : c.revision.c_str());
+    if(!p) {
+        StartupPhaseTimer timer{"load-module", c.module};
+        p = ly_ctx_load_module(ctx, c.module.c_str(), c.revision.empty() ? 0 : c.revision.c_str());
+    }
+    if(!p) {
+        BOOST_LOG_TRIVIAL(debug) << "Unable to parse module " << c.module;
+        return false;
+    }
+    for(auto f : c.features)
+        lys_features_enable(p, f.c_str());
+
+    //imports come with the module itself, the modules changing it have to be loaded too
+    for(auto & deviation : c.deviations)
+        load_module(ctx, deviation);
+    index_module_files();
+    auto augmenting = augmenters.find(c.module);
+    if(augmenting != augmenters.end()) {
+        for(auto & augmenter : augmenting->second)
+            load_module(ctx, augmenter);
+    }
+    return true;
+}
+
+// Scans the files of the pending modules for their namespace and the modules they augment or
+// deviate. Only the statements' text is looked at, a module without a file is found when it
+// is loaded itself.
+void
+LazyModuleLoader::index_module_files()
+{
+    if(module_files_indexed)
+        return;
+    module_files_indexed = true;
+
+    for(auto & entry : pending)
+    {
+        std::string text = read_module_file(search_dir, entry.second);
+        if(text.empty())
+            continue;
+        for(size_t pos = text.find("namespace"); pos != std::string::npos; pos = text.find("namespace", pos + 1))
+        {
+            if(!is_yang_keyword_at(text, pos, "namespace"))
+                continue;
+            size_t cursor = pos + 9;
+            namespaces[next_yang_token(text, cursor)] = entry.first;
+            break;
+        }
+        auto imports = get_import_prefixes(text);
+        for(auto & prefix : get_augmented_prefixes(text))
+        {
+            auto imported = imports.find(prefix);
+            if(imported != imports.end())
+                augmenters[imported->second].push_back(entry.first);
+        }
+    }
+}
+
+// the pending module of a namespace, empty if there is none
+std::string
+LazyModuleLoader::get_namespace_module(const std::string& ns)
+{
+    index_module_files();
+    auto found = namespaces.find(ns);
+    if(found != namespaces.end())
+        return pending.find(found->second) != pending.end() ? found->second : "";
+
+    //the modules without a file yet, whose namespace commonly ends with their name
+    size_t separator = ns.find_last_of(":/");
+    std::string name = (separator == std::string::npos) ? ns : ns.substr(separator + 1);
+    return pending.find(name) != pending.end() ? name : "";
+}
+
+// the module names qualifying the segments of a schema or data path, e.g. "a:x/b:y[b:k='v']"
+static std::set<std::string> get_path_prefixes(const std::string& path)
+{
+    std::set<std::string> prefixes;
+    size_t start = 0;
+    for(size_t i = 0; i < path.size(); ++i)
+    {
+        char c = path[i];
+        if(c == ':' && i > start) {
+            prefixes.insert(path.substr(start, i - start));
+        }
+        if(!std::isalnum(static_cast<unsigned char>(c)) && c != '-' && c != '_' && c != '.') {
+            start = i + 1;
+        }
+    }
+    return prefixes;
+}
+
+// the namespaces declared in an XML document
+static std::set<std::string> get_xml_namespaces(const char* data)
+{
+    std::set<std::string> namespaces;
+    for(const char* pos = std::strstr(data, "xmlns"); pos != nullptr; pos = std::strstr(pos, "xmlns"))
+    {
+        pos += 5;
+        if(*pos == ':')
+        {
+            while(*pos && *pos != '=' && !std::isspace(static_cast<unsigned char>(*pos)))
+                ++pos;
+        }
+        while(std::isspace(static_cast<unsigned char>(*pos)))
+            ++pos;
+        if(*pos != '=')
+            continue;
+        ++pos;
+        while(std::isspace(static_cast<unsigned char>(*pos)))
+            ++pos;
+        char quote = *pos;
+        if(quote != '"' && quote != '\'')
+            continue;
+        const char* end = std::strchr(++pos, quote);
+        if(end == nullptr)
+            break;
+        namespaces.emplace(pos, end);
+        pos = end + 1;
+    }
+    return namespaces;
+}
+
+// the module names qualifying the member names of a JSON document, e.g. "a" of {"a:x": {}}
+static std::set<std::string> get_json_member_prefixes(const char* data)
+{
+    std::set<std::string> prefixes;
+    for(const char* pos = std::strchr(data, '"'); pos != nullptr; pos = std::strchr(pos, '"'))
+    {
+        const char* start = ++pos;
+        while(*pos && *pos != '"')
+        {
+            if(*pos == '\\' && pos[1])
+                ++pos;
+            ++pos;
+        }
+        if(!*pos)
+            break;
+        const char* end = pos++;
+        const char* next = pos;
+        while(std::isspace(static_cast<unsigned char>(*next)))
+            ++next;
+        if(*next != ':')
+            continue;
+        auto colon = static_cast<const char*>(std::memchr(start, ':', end - start));
+        if(colon != nullptr && colon > start)
+            prefixes.emplace(start, colon);
+    }
+    return prefixes;
+}
+
+static std::string read_module_file(const fs::path& search_dir, const Capability& capability)
+{
+    std::vector<fs::path> candidates;
+    if(!capability.revision.empty())
+        candidates.push_back(search_dir / (capability.module + "@" + capability.revision + ".yang"));
+    candidates.push_back(search_dir / (capability.module + ".yang"));
+
+    for(auto & candidate : candidates)
+    {
+        std::ifstream file{candidate.string()};
+        if(file.is_open())
+            return std::string{std::istreambuf_iterator<char>{file}, std::istreambuf_iterator<char>{}};
+    }
+    return "";
+}
+
+// prefix -> module, from the import statements of a module
+static std::map<std::string, std::string> get_import_prefixes(const std::string& text)
+{
+    std::map<std::string, std::string> imports;
+    for(size_t pos = text.find("import"); pos != std::string::npos; pos = text.find("import", pos + 1))
+    {
+        if(!is_yang_keyword_at(text, pos, "import"))
+            continue;
+        size_t cursor = pos + 6;
+        std::string module = next_yang_token(text, cursor);
+        size_t body_end = text.find('}', cursor);
+        size_t prefix_pos = text.find("prefix", cursor);
+        if(prefix_pos == std::string::npos || prefix_pos > body_end)
+            continue;
+        cursor = prefix_pos + 6;
+        imports[next_yang_token(text, cursor)] = module;
+    }
+    return imports;
+}
+
+// the prefixes of the nodes targeted by the augment and deviation statements of a module
+static std::set<std::string> get_augmented_prefixes(const std::string& text)
+{
+    std::set<std::string> prefixes;
+    for(std::string keyword : {"augment", "deviation"})
+    {
+        for(size_t pos = text.find(keyword); pos != std::string::npos; pos = text.find(keyword, pos + 1))
+        {
+            if(!is_yang_keyword_at(text, pos, keyword))
+                continue;
+            size_t cursor = pos + keyword.size();
+            std::string target = next_yang_token(text, cursor);
+            size_t colon = target.find(':');
+            if(target.size() > 1 && target[0] == '/' && colon != std::string::npos)
+                prefixes.insert(target.substr(1, colon - 1));
+        }
+    }
+    return prefixes;
+}
+
+}
+}
+
+std::string
+ydk::path::next_yang_token(const std::string& text, size_t& pos)
+{
+    while(pos < text.size() && std::isspace(static_cast<unsigned char>(text[pos])))
+        ++pos;
+    if(pos < text.size() && (text[pos] == '"' || text[pos] == '\''))
+        ++pos;
+    size_t start = pos;
+    while(pos < text.size() && !std::isspace(static_cast<unsigned char>(text[pos]))
+          && text[pos] != ';' && text[pos] != '{' && text[pos] != '"' && text[pos] != '\'')
+        ++pos;
+    return text.substr(start, pos - start);
+}
+
+bool
+ydk::path::is_yang_keyword_at(const std::string& text, size_t pos, const std::string& keyword)
+{
+    size_t end = pos + keyword.size();
+    return (pos == 0 || std::isspace(static_cast<unsigned char>(text[pos - 1]))
+            || text[pos - 1] == ';' || text[pos - 1] == '{' || text[pos - 1] == '}')
+           && end < text.size() && std::isspace(static_cast<unsigned char>(text[end]));
+}
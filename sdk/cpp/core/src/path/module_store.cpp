@@ -0,0 +1,161 @@
+/// YANG Development Kit
+// Copyright 2016 Cisco Systems. All rights reserved
+//
+////////////////////////////////////////////////////////////////
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+//
+//////////////////////////////////////////////////////////////////
+
+
+#include "path_private.hpp"
+#include <boost/log/trivial.hpp>
+#include <cstdint>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+namespace fs = boost::filesystem;
+
+namespace ydk
+{
+namespace path
+{
+
+static const char* OBJECTS = "objects";
+static const char* MODULES = "modules";
+
+static std::string checksum(const std::string& data);
+static bool read_file(const fs::path& file, std::string& data);
+static bool write_file_atomically(const fs::path& file, const std::string& data);
+
+ModuleStore::ModuleStore(const fs::path& directory) : directory{directory}
+{
+    boost::system::error_code ec;
+    fs::create_directories(directory / OBJECTS, ec);
+    fs::create_directories(directory / MODULES, ec);
+}
+
+bool
+ModuleStore::find(const std::string& name, const std::string& revision, std::string& data, fs::path& stored) const
+{
+    if(revision.empty())
+        return false;
+
+    std::string sum;
+    if(!read_file(directory / MODULES / (name + "@" + revision), sum))
+        return false;
+    fs::path object = directory / OBJECTS / (sum + ".yang");
+    if(!read_file(object, data))
+        return false;
+    if(checksum(data) != sum) {
+        BOOST_LOG_TRIVIAL(debug) << "Module store file " << object.string() << " does not match its checksum, ignoring it";
+        data.clear();
+        return false;
+    }
+    stored = object;
+    BOOST_LOG_TRIVIAL(trace) << "Module store hit " << name << "@" << revision;
+    return true;
+}
+
+fs::path
+ModuleStore::add(const std::string& name, const std::string& revision, const std::string& data) const
+{
+    if(revision.empty() || data.empty())
+        return fs::path{};
+
+    std::string sum = checksum(data);
+    fs::path object = directory / OBJECTS / (sum + ".yang");
+    // the same content always goes to the same object, whichever writer gets there first
+    if(!fs::is_regular_file(object) && !write_file_atomically(object, data))
+        return fs::path{};
+    if(!write_file_atomically(directory / MODULES / (name + "@" + revision), sum))
+        return fs::path{};
+    BOOST_LOG_TRIVIAL(debug) << "Stored module " << name << "@" << revision << " as " << object.string();
+    return object;
+}
+
+bool
+ModuleStore::install(const fs::path& stored, const fs::path& file_path)
+{
+    boost::system::error_code ec;
+    if(fs::exists(file_path, ec))
+        return true;
+    // a hard link costs no copy; across file systems the file has to be copied
+    fs::create_hard_link(stored, file_path, ec);
+    if(!ec || fs::exists(file_path))
+        return true;
+    ec.clear();
+    fs::path staging = file_path.parent_path() / fs::unique_path(file_path.filename().string() + ".%%%%-%%%%");
+    fs::copy_file(stored, staging, ec);
+    if(!ec)
+        fs::rename(staging, file_path, ec);
+    if(ec) {
+        fs::remove(staging, ec);
+        return fs::exists(file_path);
+    }
+    return true;
+}
+
+// FNV-1a, stable across processes and platforms unlike std::hash
+static std::string checksum(const std::string& data)
+{
+    std::uint64_t hash = 14695981039346656037ULL;
+    for(unsigned char c : data)
+    {
+        hash ^= c;
+        hash *= 1099511628211ULL;
+    }
+    std::ostringstream sum{};
+    sum << std::hex << std::setw(16) << std::setfill('0') << hash << "-" << std::dec << data.size();
+    return sum.str();
+}
+
+static bool read_file(const fs::path& file, std::string& data)
+{
+    std::ifstream source{file.string(), std::ios::binary};
+    if(!source.is_open())
+        return false;
+    data.assign(std::istreambuf_iterator<char>{source}, std::istreambuf_iterator<char>{});
+    return !source.bad();
+}
+
+// written aside and renamed into place, so that concurrent readers and writers, in this
+// process or another, only ever see complete files
+static bool write_file_atomically(const fs::path& file, const std::string& data)
+{
+    fs::path staging = file.parent_path() / fs::unique_path(file.filename().string() + ".tmp.%%%%-%%%%-%%%%");
+    std::ofstream sink{staging.string(), std::ios::binary};
+    sink << data;
+    sink.close();
+    boost::system::error_code ec;
+    if(!sink) {
+        BOOST_LOG_TRIVIAL(debug) << "Cannot write module store file " << staging.string();
+        fs::remove(staging, ec);
+        return false;
+    }
+    fs::rename(staging, file, ec);
+    if(ec) {
+        BOOST_LOG_TRIVIAL(debug) << "Cannot write module store file " << file.string() << ": " << ec.message();
+        fs::remove(staging, ec);
+        return false;
+    }
+    return true;
+}
+
+}
+}
@@ -63,6 +63,16 @@ ydk::path::ServiceProvider::~ServiceProvider()
 
 }
 
+bool ydk::path::ServiceProvider::supports_attached_data(const std::string&) const
+{
+    return false;
+}
+
+void ydk::path::ServiceProvider::record_read_populate(bool, std::chrono::steady_clock::duration) const
+{
+
+}
+
 
 
 /////////////////////////////////////////////////////////////////////////
@@ -146,53 +156,95 @@ namespace ydk {
         }
 
 
-        std::unique_ptr<SchemaValueIdentityType> create_identity_type(struct ly_set *ident)
+        SchemaValueType* SchemaValueTypeCache::get_type(struct lys_node_leaf* leaf)
         {
-            auto identity_type = std::make_unique<SchemaValueIdentityType>();
-            if(!ident) return identity_type;
+            std::lock_guard<std::mutex> lock{m_mutex};
+            return get_type(leaf, &(leaf->type));
+        }
 
-            for(unsigned int i=0;i<ident->number && i<=272;i++) //272 temporary workaround for ietf-interfaces
-            {
-				identity_type->module_name = ident->set.s[i]->module->name;
-				identity_type->name = ident->set.s[i]->name;
-                                struct lys_ident* iden = ((struct lys_ident*)ident->set.s[i]);
+        void SchemaValueTypeCache::refresh_identities()
+        {
+            std::lock_guard<std::mutex> lock{m_mutex};
+            // the identities created meanwhile are created with all they derive
+            std::vector<std::pair<const struct lys_ident*, SchemaValueIdentityType*>> identities{m_identities.begin(), m_identities.end()};
+            for(auto & identity : identities) {
+                unsigned int count = identity.first->der ? identity.first->der->number : 0;
+                if(count != identity.second->derived.size()) {
+                    set_derived(identity.first, *identity.second);
+                }
+            }
+        }
 
-                if(iden->der && iden->der->number > 0)
-				{
-					identity_type->derived.push_back(create_identity_type(iden->der));
-				}
+        SchemaValueType* SchemaValueTypeCache::get_type(struct lys_node_leaf* leaf, struct lys_type* type)
+        {
+            // empty types carry the name of their leaf, they are not shared
+            if(type->base == LY_TYPE_EMPTY) {
+                return create_type(leaf, type);
+            }
 
+            auto it = m_types.find(type);
+            if(it != m_types.end()) {
+                return it->second;
             }
-            return identity_type;
 
+            // the types derived without restrictions of their own map to the type they derive from
+            SchemaValueType* value_type = create_type(leaf, type);
+            m_types.emplace(type, value_type);
+            return value_type;
         }
 
+        SchemaValueType* SchemaValueTypeCache::add(std::unique_ptr<SchemaValueType> value_type)
+        {
+            m_owned.push_back(std::move(value_type));
+            return m_owned.back().get();
+        }
 
-        std::unique_ptr<SchemaValueIdentityType> create_identity_type(struct lys_ident **ident, int count)
+        SchemaValueIdentityType* SchemaValueTypeCache::get_identity(const struct lys_ident* ident)
         {
+            auto it = m_identities.find(ident);
+            if(it != m_identities.end()) {
+                return it->second;
+            }
 
-            auto identity_type = std::make_unique<SchemaValueIdentityType>();
-            if(!ident) return identity_type;
+            auto identity = std::make_unique<SchemaValueIdentityType>();
+            identity->module_name = ident->module->name;
+            identity->name = ident->name;
+            SchemaValueIdentityType* identity_type = identity.get();
+            add(std::move(identity));
+            m_identities.emplace(ident, identity_type);
+            set_derived(ident, *identity_type);
+            return identity_type;
+        }
 
-            for(int i=0;i<count;i++)
-            {
-				identity_type->module_name = ident[i]->module->name;
-				identity_type->name = ident[i]->name;
+        void SchemaValueTypeCache::set_derived(const struct lys_ident* ident, SchemaValueIdentityType& identity_type)
+        {
+            identity_type.derived.clear();
+            if(ident->der) {
+                for(unsigned int i=0; i < ident->der->number; i++) {
+                    identity_type.derived.push_back(get_identity(reinterpret_cast<struct lys_ident*>(ident->der->set.s[i])));
+                }
+            }
+        }
 
-                if(ident[i]->der && ident[i]->der->number > 0)
-				{
-					identity_type->derived.push_back(create_identity_type(ident[i]->der));
-				}
+        SchemaValueType* SchemaValueTypeCache::get_identity_type(struct lys_ident** ident, unsigned int count)
+        {
+            if(count == 1) {
+                return get_identity(ident[0]);
+            }
 
+            // several bases, any of them or the identities derived from them will do
+            auto identity_type = std::make_unique<SchemaValueIdentityType>();
+            for(unsigned int i=0; i < count; i++) {
+                identity_type->module_name = ident[i]->module->name;
+                identity_type->name = ident[i]->name;
+                identity_type->derived.push_back(get_identity(ident[i]));
             }
-            return identity_type;
+            return add(std::move(identity_type));
         }
 
-        std::unique_ptr<SchemaValueType> create_schema_value_type(struct lys_node_leaf* leaf,
-                                                  struct lys_type* type)
+        SchemaValueType* SchemaValueTypeCache::create_type(struct lys_node_leaf* leaf, struct lys_type* type)
         {
-
-            std::unique_ptr<SchemaValueType> m_type = nullptr;
+            SchemaValueType* m_type = nullptr;
 
             LY_DATA_TYPE data_type = type->base;
 
@@ -201,11 +253,11 @@ namespace ydk {
                     if(type->info.binary.length){
                         auto binary = std::make_unique<SchemaValueBinaryType>();
                         parse_range_intervals(binary->length, type->info.binary.length->expr);
-                        m_type = std::move(binary);
+                        m_type = add(std::move(binary));
                     } else if(type->der){
-                        m_type = create_schema_value_type(leaf, &(type->der->type));
+                        m_type = get_type(leaf, &(type->der->type));
                     } else {
-                    	m_type = std::make_unique<SchemaValueBinaryType>();
+                    	m_type = add(std::make_unique<SchemaValueBinaryType>());
                     }
 
                     break;
@@ -222,19 +274,19 @@ namespace ydk {
                 		);
                 	}
 
-                    m_type = std::make_unique<SchemaValueBitsType>(bit_values);
+                    m_type = add(std::make_unique<SchemaValueBitsType>(bit_values));
                     break;
                 }
                 case LY_TYPE_BOOL: {
-                    m_type = std::make_unique<SchemaValueBoolType>();
+                    m_type = add(std::make_unique<SchemaValueBoolType>());
                     break;
                 }
                 case LY_TYPE_DEC64: {
-                    m_type = std::make_unique<SchemaValueDec64Type>();
+                    m_type = add(std::make_unique<SchemaValueDec64Type>());
                     break;
                 }
                 case LY_TYPE_EMPTY: {
-                    m_type = std::make_unique<SchemaValueEmptyType>(leaf->name);
+                    m_type = add(std::make_unique<SchemaValueEmptyType>(leaf->name));
                     break;
                 }
                 case LY_TYPE_ENUM: {
@@ -247,9 +299,9 @@ namespace ydk {
 									};
                             enum_type->enums.push_back(enum_);
                         }
-                        m_type = std::move(enum_type);
+                        m_type = add(std::move(enum_type));
                     } else if(type->der){
-                        m_type = create_schema_value_type(leaf, &(type->der->type));
+                        m_type = get_type(leaf, &(type->der->type));
                     } else {
                         BOOST_LOG_TRIVIAL(error) << "Unable to determine union's types: " << leaf->name <<", module: "<< leaf->module->name;
                         BOOST_THROW_EXCEPTION(ydk::YCPPIllegalStateError{"Unable to determine union's types"});
@@ -258,9 +310,9 @@ namespace ydk {
                 }
                 case LY_TYPE_IDENT: {
                     if(type->info.ident.ref) {
-                        m_type = create_identity_type(type->info.ident.ref, type->info.ident.count);
+                        m_type = get_identity_type(type->info.ident.ref, type->info.ident.count);
                     } else if(type->der){
-                        m_type = create_schema_value_type(leaf, &(type->der->type));
+                        m_type = get_type(leaf, &(type->der->type));
                     } else {
                         BOOST_LOG_TRIVIAL(error) << "Unable to determine identity type: " << leaf->name <<", module: "<< leaf->module->name;
                         std::ostringstream os;
@@ -270,16 +322,16 @@ namespace ydk {
                     break;
                 }
                 case LY_TYPE_INST: {
-                    m_type = std::make_unique<SchemaValueInstanceIdType>();
+                    m_type = add(std::make_unique<SchemaValueInstanceIdType>());
                     break;
                 }
                 case LY_TYPE_LEAFREF: {
                     if(type->info.lref.target) {
-                        m_type = create_schema_value_type(type->info.lref.target, &(type->info.lref.target->type));
+                        m_type = get_type(type->info.lref.target, &(type->info.lref.target->type));
                     } else if(type->der) {
-                        m_type = create_schema_value_type(leaf, &(type->der->type));
+                        m_type = get_type(leaf, &(type->der->type));
                     } else {
-                    	m_type = std::make_unique<SchemaValueStringType>();//TODO temporary workaround
+                    	m_type = add(std::make_unique<SchemaValueStringType>());//TODO temporary workaround
 //                        BOOST_LOG_TRIVIAL(error) << "Unable to determine leafref type: " << leaf->name <<", module: "<< leaf->module->name;
 //                        std::ostringstream os;
 //                        os << "Unable to determine leafref type: " << leaf->name <<", module: "<< leaf->module->name;
@@ -288,30 +340,26 @@ namespace ydk {
                     break;
                 }
                 case LY_TYPE_STRING: {
-                    if(type->info.str.length) {
+                    if(type->info.str.length || type->info.str.pat_count != 0 || !type->der) {
                         auto stringType = std::make_unique<SchemaValueStringType>();
-                        parse_range_intervals(stringType->length, type->info.str.length->expr);
 
-                        if(type->info.str.pat_count != 0){
-                            for(int i =0; i < type->info.str.pat_count; i++) {
-                                stringType->patterns.push_back(type->info.str.patterns[i].expr);
+                        // the value has to match the patterns of the types this one derives from
+                        // too, the length restriction closest to the leaf applies
+                        bool length_parsed = false;
+                        for(struct lys_type* str_type = type; str_type != nullptr;
+                                str_type = str_type->der ? &(str_type->der->type) : nullptr) {
+                            if(!length_parsed && str_type->info.str.length) {
+                                parse_range_intervals(stringType->length, str_type->info.str.length->expr);
+                                length_parsed = true;
                             }
-                        }
-                        m_type = std::move(stringType);
-
-                    } else if(type->der){
-                        m_type = create_schema_value_type(leaf, &(type->der->type));
-                    } else {
-                        auto stringType = std::make_unique<SchemaValueStringType>();
-
-                        if(type->info.str.pat_count != 0){
-                            for(int i=0; i < type->info.str.pat_count; i++) {
-                                stringType->patterns.push_back(type->info.str.patterns[i].expr);
+                            for(int i=0; i < str_type->info.str.pat_count; i++) {
+                                stringType->patterns.push_back(str_type->info.str.patterns[i].expr);
                             }
                         }
 
-                        m_type = std::move(stringType);
-
+                        m_type = add(std::move(stringType));
+                    } else {
+                        m_type = get_type(leaf, &(type->der->type));
                     }
                     break;
                 }
@@ -320,11 +368,11 @@ namespace ydk {
                     if(type->info.uni.count != 0) {
                         auto unionType = std::make_unique<SchemaValueUnionType>();
                         for(int i=0; i< type->info.uni.count; ++i) {
-                            unionType->types.push_back(create_schema_value_type(leaf,&(type->info.uni.types[i])));
+                            unionType->types.push_back(get_type(leaf,&(type->info.uni.types[i])));
                         }
-                        m_type = std::move(unionType);
+                        m_type = add(std::move(unionType));
                     } else if(type->der){
-                        m_type = create_schema_value_type(leaf, &(type->der->type));
+                        m_type = get_type(leaf, &(type->der->type));
                     } else {
                         BOOST_LOG_TRIVIAL(error) << "Unable to determine union's types: " << leaf->name <<", module: "<< leaf->module->name;
                         std::ostringstream os;
@@ -342,12 +390,12 @@ namespace ydk {
                             				static_cast<int8_t>(127)
                         				);
                         parse_range_intervals(int8_type->range, type->info.num.range->expr);
-                        m_type = std::move(int8_type);
+                        m_type = add(std::move(int8_type));
                     } else if(type->der) {
-                        m_type = create_schema_value_type(leaf, &(type->der->type));
+                        m_type = get_type(leaf, &(type->der->type));
                     } else {
-                        m_type = std::make_unique<SchemaValueNumberType<int8_t>>( static_cast<int8_t>(-128),
-                            static_cast<int8_t>(127) );
+                        m_type = add(std::make_unique<SchemaValueNumberType<int8_t>>( static_cast<int8_t>(-128),
+                            static_cast<int8_t>(127) ));
                     }
                     break;
                 }
@@ -356,11 +404,11 @@ namespace ydk {
                     if(type->info.num.range) {
                         auto uint8_type = std::make_unique<SchemaValueNumberType<uint8_t>>( static_cast<uint8_t>(0),static_cast<uint8_t>(255) );
                         parse_range_intervals(uint8_type->range, type->info.num.range->expr);
-                        m_type = std::move(uint8_type);
+                        m_type = add(std::move(uint8_type));
                     } else if(type->der) {
-                        m_type = create_schema_value_type(leaf, &(type->der->type));
+                        m_type = get_type(leaf, &(type->der->type));
                     } else {
-                        m_type = std::make_unique<SchemaValueNumberType<uint8_t>>( static_cast<uint8_t>(0),static_cast<uint8_t>(255) );
+                        m_type = add(std::make_unique<SchemaValueNumberType<uint8_t>>( static_cast<uint8_t>(0),static_cast<uint8_t>(255) ));
                     }
                     break;
                 }
@@ -370,11 +418,11 @@ namespace ydk {
                     if(type->info.num.range) {
                         auto int16_type = std::make_unique<SchemaValueNumberType<int16_t>>( static_cast<int16_t>(-32768),static_cast<int16_t>(32767) );
                         parse_range_intervals(int16_type->range, type->info.num.range->expr);
-                        m_type = std::move(int16_type);
+                        m_type = add(std::move(int16_type));
                     } else if(type->der) {
-                        m_type = create_schema_value_type(leaf, &(type->der->type));
+                        m_type = get_type(leaf, &(type->der->type));
                     } else {
-                        m_type = std::make_unique<SchemaValueNumberType<int16_t>>( static_cast<int16_t>(-32768),static_cast<int16_t>(32767) );
+                        m_type = add(std::make_unique<SchemaValueNumberType<int16_t>>( static_cast<int16_t>(-32768),static_cast<int16_t>(32767) ));
                     }
                     break;
                 }
@@ -383,11 +431,11 @@ namespace ydk {
                     if(type->info.num.range) {
                         auto uint16_type = std::make_unique<SchemaValueNumberType<uint16_t>>( static_cast<uint16_t>(0),static_cast<uint16_t>(65535) );
                         parse_range_intervals(uint16_type->range, type->info.num.range->expr);
-                        m_type = std::move(uint16_type);
+                        m_type = add(std::move(uint16_type));
                     } else if(type->der) {
-                        m_type = create_schema_value_type(leaf, &(type->der->type));
+                        m_type = get_type(leaf, &(type->der->type));
                     } else {
-                        m_type = std::make_unique<SchemaValueNumberType<uint16_t>>( static_cast<uint16_t>(0),static_cast<uint16_t>(65535) );
+                        m_type = add(std::make_unique<SchemaValueNumberType<uint16_t>>( static_cast<uint16_t>(0),static_cast<uint16_t>(65535) ));
                     }
                     break;
                 }
@@ -396,11 +444,11 @@ namespace ydk {
                     if(type->info.num.range) {
                         auto int32_type = std::make_unique<SchemaValueNumberType<int32_t>>( static_cast<int32_t>(-2147483648),static_cast<int32_t>(2147483647) );
                         parse_range_intervals(int32_type->range, type->info.num.range->expr);
-                        m_type = std::move(int32_type);
+                        m_type = add(std::move(int32_type));
                     } else if(type->der) {
-                        m_type = create_schema_value_type(leaf, &(type->der->type));
+                        m_type = get_type(leaf, &(type->der->type));
                     } else {
-                        m_type = std::make_unique<SchemaValueNumberType<int32_t>>( static_cast<int32_t>(-2147483648),static_cast<int32_t>(2147483647) );
+                        m_type = add(std::make_unique<SchemaValueNumberType<int32_t>>( static_cast<int32_t>(-2147483648),static_cast<int32_t>(2147483647) ));
                     }
                     break;
                 }
@@ -409,11 +457,11 @@ namespace ydk {
                     if(type->info.num.range) {
                         auto uint32_type = std::make_unique<SchemaValueNumberType<uint32_t>>( static_cast<uint32_t>(0),static_cast<uint32_t>(4294967295) );
                         parse_range_intervals(uint32_type->range, type->info.num.range->expr);
-                        m_type = std::move(uint32_type);
+                        m_type = add(std::move(uint32_type));
                     } else if(type->der) {
-                        m_type = create_schema_value_type(leaf, &(type->der->type));
+                        m_type = get_type(leaf, &(type->der->type));
                     } else {
-                        m_type = std::make_unique<SchemaValueNumberType<uint32_t>>( static_cast<uint32_t>(0),static_cast<uint32_t>(4294967295) );
+                        m_type = add(std::make_unique<SchemaValueNumberType<uint32_t>>( static_cast<uint32_t>(0),static_cast<uint32_t>(4294967295) ));
                     }
                     break;
                 }
@@ -423,11 +471,11 @@ namespace ydk {
                     if(type->info.num.range) {
                         auto int64_type = std::make_unique<SchemaValueNumberType<int64_t>>( static_cast<int64_t>(-9223372036854775807),static_cast<int64_t>(9223372036854775807) );
                         parse_range_intervals(int64_type->range, type->info.num.range->expr);
-                        m_type = std::move(int64_type);
+                        m_type = add(std::move(int64_type));
                     } else if(type->der) {
-                        m_type = create_schema_value_type(leaf, &(type->der->type));
+                        m_type = get_type(leaf, &(type->der->type));
                     } else {
-                        m_type = std::make_unique<SchemaValueNumberType<int64_t>>( static_cast<int64_t>(-9223372036854775807),static_cast<int64_t>(9223372036854775807) );
+                        m_type = add(std::make_unique<SchemaValueNumberType<int64_t>>( static_cast<int64_t>(-9223372036854775807),static_cast<int64_t>(9223372036854775807) ));
                     }
                     break;
                 }
@@ -435,11 +483,11 @@ namespace ydk {
                     if(type->info.num.range) {
                         auto uint64_type = std::make_unique<SchemaValueNumberType<uint64_t>>( static_cast<uint64_t>(0),static_cast<uint64_t>(18446744073709551615ULL) );
                         parse_range_intervals(uint64_type->range, type->info.num.range->expr);
-                        m_type = std::move(uint64_type);
+                        m_type = add(std::move(uint64_type));
                     } else if(type->der) {
-                        m_type = create_schema_value_type(leaf, &(type->der->type));
+                        m_type = get_type(leaf, &(type->der->type));
                     } else {
-                        m_type = std::make_unique<SchemaValueNumberType<uint64_t>>( static_cast<uint64_t>(0),static_cast<uint64_t>(18446744073709551615ULL) );
+                        m_type = add(std::make_unique<SchemaValueNumberType<uint64_t>>( static_cast<uint64_t>(0),static_cast<uint64_t>(18446744073709551615ULL) ));
                     }
                     break;
                 }
@@ -453,13 +501,6 @@ namespace ydk {
 
             return m_type;
         }
-
-        std::unique_ptr<SchemaValueType> create_schema_value_type(struct lys_node_leaf* leaf)
-        {
-            return create_schema_value_type(leaf, &(leaf->type));
-        }
-
-
     }
 }
 
@@ -499,6 +540,7 @@ ydk::path::ValidationService::validate(const ydk::path::DataNode* dn, ydk::path:
     //what kind of a DataNode is this
     const ydk::path::DataNodeImpl* dn_impl = dynamic_cast<const ydk::path::DataNodeImpl*>(dn);
     if(dn_impl){
+        SchemaReadLock read_lock{dn_impl->schema()};
         struct lyd_node* lynode = dn_impl->m_node;
         int rc = lyd_validate(&lynode,ly_option, NULL);
         if(rc) {
@@ -546,6 +588,7 @@ ydk::path::CodecService::encode(const ydk::path::DataNode* dn, ydk::path::CodecS
     }
     char* buffer;
     BOOST_LOG_TRIVIAL(trace) << "Performing encode operation";
+    SchemaReadLock read_lock{impl->schema()};
 
     if(!lyd_print_mem(&buffer, m_node,scheme, (pretty ? LYP_FORMAT : 0)|LYP_WD_ALL|LYP_KEEPEMPTYCONT)) {
     	if(!buffer)
@@ -563,8 +606,77 @@ ydk::path::CodecService::encode(const ydk::path::DataNode* dn, ydk::path::CodecS
 
 }
 
+static ydk::path::DataNode* create_root_data(const ydk::path::RootSchemaNodeImpl* rs_impl, struct lyd_node* root)
+{
+    ydk::path::RootDataImpl* rd = new ydk::path::RootDataImpl{rs_impl, rs_impl->m_ctx, "/"};
+    rd->m_node = root;
+
+    struct lyd_node* dnode = root;
+    do
+    {
+        ydk::path::DataNodeImpl* nodeImpl = new ydk::path::DataNodeImpl{rd, dnode};
+        rd->child_map.insert(std::make_pair(dnode, nodeImpl));
+        dnode = dnode->next;
+    } while(dnode && dnode != nullptr && dnode != root);
+
+    return rd;
+}
+
+// top level containers of the piece already in the tree get the children of the piece's
+// container, everything else is appended to the top level siblings of the tree
+static void merge_top_level(struct lyd_node* & tree, struct lyd_node* piece)
+{
+    if(tree == nullptr)
+    {
+        tree = piece;
+        return;
+    }
+
+    while(piece != nullptr)
+    {
+        struct lyd_node* next = piece->next;
+        struct lyd_node* existing = nullptr;
+        if(piece->schema->nodetype == LYS_CONTAINER)
+        {
+            struct lyd_node* iter = nullptr;
+            LY_TREE_FOR(tree, iter)
+            {
+                if(iter->schema == piece->schema)
+                {
+                    existing = iter;
+                    break;
+                }
+            }
+        }
+
+        if(existing)
+        {
+            struct lyd_node* child = piece->child;
+            while(child != nullptr)
+            {
+                struct lyd_node* next_child = child->next;
+                lyd_insert(existing, child);
+                child = next_child;
+            }
+            lyd_free(piece);
+        }
+        else
+        {
+            // the prev pointer of the first sibling refers to the last one
+            lyd_insert_after(tree->prev, piece);
+        }
+        piece = next;
+    }
+}
+
 ydk::path::DataNode*
 ydk::path::CodecService::decode(const RootSchemaNode* root_schema, const std::string& buffer, CodecService::Format format)
+{
+    return decode(root_schema, buffer.c_str(), format);
+}
+
+ydk::path::DataNode*
+ydk::path::CodecService::decode(const RootSchemaNode* root_schema, const char* buffer, CodecService::Format format)
 {
     LYD_FORMAT scheme = LYD_XML;
     if (format == CodecService::Format::JSON)
@@ -579,7 +691,9 @@ ydk::path::CodecService::decode(const RootSchemaNode* root_schema, const std::st
         BOOST_THROW_EXCEPTION(YCPPCoreError{"Root Schema Node is null"});
     }
 
-    struct lyd_node *root = lyd_parse_mem(rs_impl->m_ctx, buffer.c_str(), scheme, LYD_OPT_TRUSTED |  LYD_OPT_GET);
+    rs_impl->load_modules(buffer, format);
+    SchemaReadLock read_lock{rs_impl};
+    struct lyd_node *root = lyd_parse_mem(rs_impl->m_ctx, buffer, scheme, LYD_OPT_TRUSTED |  LYD_OPT_GET);
     if( root == nullptr || ly_errno )
     {
 
@@ -588,17 +702,86 @@ ydk::path::CodecService::decode(const RootSchemaNode* root_schema, const std::st
     }
 
     BOOST_LOG_TRIVIAL(trace) << "Performing decode operation";
-    RootDataImpl* rd = new RootDataImpl{rs_impl, rs_impl->m_ctx, "/"};
-    rd->m_node = root;
+    return create_root_data(rs_impl, root);
+}
 
-    struct lyd_node* dnode = root;
-    do
+ydk::path::DataNode*
+ydk::path::CodecService::decode_notification(const RootSchemaNode* root_schema, const char* buffer, CodecService::Format format)
+{
+    LYD_FORMAT scheme = (format == CodecService::Format::JSON) ? LYD_JSON : LYD_XML;
+
+    const RootSchemaNodeImpl* rs_impl = dynamic_cast<const RootSchemaNodeImpl*>(root_schema);
+    if(!rs_impl)
     {
-        DataNodeImpl* nodeImpl = new DataNodeImpl{rd, dnode};
-        rd->child_map.insert(std::make_pair(root, nodeImpl));
-        dnode = dnode->next;
-    } while(dnode && dnode != nullptr && dnode != root);
+        BOOST_LOG_TRIVIAL(error) << "Root Schema Node is nullptr";
+        BOOST_THROW_EXCEPTION(YCPPCoreError{"Root Schema Node is null"});
+    }
 
-    return rd;
+    // the data tree notifications may refer to is not at hand, references are not resolved
+    rs_impl->load_modules(buffer, format);
+    SchemaReadLock read_lock{rs_impl};
+    struct lyd_node *root = lyd_parse_mem(rs_impl->m_ctx, buffer, scheme, LYD_OPT_NOTIF | LYD_OPT_TRUSTED, nullptr);
+    if( root == nullptr || ly_errno )
+    {
+        BOOST_LOG_TRIVIAL(error) << "Parsing notification failed with message " << ly_errmsg();
+        BOOST_THROW_EXCEPTION(YCPPCodecError{YCPPCodecError::Error::XML_INVAL});
+    }
+
+    BOOST_LOG_TRIVIAL(trace) << "Performing notification decode operation";
+    return create_root_data(rs_impl, root);
+}
+
+ydk::path::StreamingDecoder::StreamingDecoder(const RootSchemaNode* root_schema, CodecService::Format format)
+    : m_root_schema{root_schema}, m_format{format}, m_tree{nullptr}
+{
+    if(!dynamic_cast<const RootSchemaNodeImpl*>(root_schema))
+    {
+        BOOST_LOG_TRIVIAL(error) << "Root Schema Node is nullptr";
+        BOOST_THROW_EXCEPTION(YCPPCoreError{"Root Schema Node is null"});
+    }
+}
+
+ydk::path::StreamingDecoder::~StreamingDecoder()
+{
+    if(m_tree)
+    {
+        lyd_free_withsiblings(m_tree);
+    }
+}
+
+void
+ydk::path::StreamingDecoder::add(const char* buffer)
+{
+    const RootSchemaNodeImpl* rs_impl = dynamic_cast<const RootSchemaNodeImpl*>(m_root_schema);
+    LYD_FORMAT scheme = (m_format == CodecService::Format::JSON) ? LYD_JSON : LYD_XML;
+
+    rs_impl->load_modules(buffer, m_format);
+    SchemaReadLock read_lock{rs_impl};
+    struct lyd_node *piece = lyd_parse_mem(rs_impl->m_ctx, buffer, scheme, LYD_OPT_TRUSTED |  LYD_OPT_GET);
+    if( piece == nullptr )
+    {
+        if( ly_errno )
+        {
+            BOOST_LOG_TRIVIAL(error) << "Parsing failed with message " << ly_errmsg();
+            BOOST_THROW_EXCEPTION(YCPPCodecError{YCPPCodecError::Error::XML_INVAL});
+        }
+        return;
+    }
+
+    BOOST_LOG_TRIVIAL(trace) << "Merging decoded document";
+    merge_top_level(m_tree, piece);
+}
+
+ydk::path::DataNode*
+ydk::path::StreamingDecoder::finish()
+{
+    if(m_tree == nullptr)
+    {
+        return nullptr;
+    }
+
+    struct lyd_node* tree = m_tree;
+    m_tree = nullptr;
+    return create_root_data(dynamic_cast<const RootSchemaNodeImpl*>(m_root_schema), tree);
 }
 
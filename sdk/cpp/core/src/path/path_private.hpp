@@ -33,16 +33,21 @@
 #include "libyang/xml.h"
 
 #include "../path_api.hpp"
+#include "../startup_profile.hpp"
 
 #include <algorithm>
+#include <atomic>
 #include <map>
+#include <mutex>
+#include <set>
+#include <shared_mutex>
 #include <cstdlib>
 #include <functional>
 #include <iostream>
 #include <cstring>
 #include <cassert>
 #include <sstream>
-#include <regex>
+#include <unordered_map>
 #include <boost/filesystem.hpp>
 #include <cstdio>
 #include <boost/iostreams/stream.hpp>
@@ -54,6 +59,30 @@ namespace ydk {
 
         std::vector<std::string> segmentalize(const std::string& path);
 
+        ///
+        /// The children of a schema node. Modules loaded lazily add children to nodes already
+        /// handed out, so rather than growing the vector callers may be iterating over, the
+        /// nodes are published in a new vector holding the current ones followed by the added
+        /// ones. The vectors published before are left as they were and kept until the parent
+        /// goes, only the last one owning the nodes. Publishing is serialized by the callers.
+        ///
+        class SchemaChildren
+        {
+        public:
+            SchemaChildren();
+            ~SchemaChildren();
+
+            SchemaChildren(const SchemaChildren&) = delete;
+            SchemaChildren& operator=(const SchemaChildren&) = delete;
+
+            const std::vector<std::unique_ptr<SchemaNode>>& get() const;
+            void append(std::vector<std::unique_ptr<SchemaNode>> added);
+
+        private:
+            std::atomic<const std::vector<std::unique_ptr<SchemaNode>>*> m_current;
+            std::vector<std::unique_ptr<std::vector<std::unique_ptr<SchemaNode>>>> m_published;
+        };
+
 
         class SchemaNodeImpl : public SchemaNode
         {
@@ -63,6 +92,8 @@ namespace ydk {
             virtual ~SchemaNodeImpl();
 
             std::string path() const;
+            /// the path, worked out on the first call and kept by the node
+            const std::string& cached_path() const;
 
             std::vector<SchemaNode*> find(const std::string& path) const;
 
@@ -80,19 +111,136 @@ namespace ydk {
 
             SchemaValueType & type() const;
 
+            /// whether the wrappers of the children were created, they are on the first children()
+            bool children_built() const;
+
             const SchemaNode* m_parent;
             struct lys_node* m_node;
-            std::vector<std::unique_ptr<SchemaNode>> m_children;
+            // the children and the type of a leaf are only created when first asked for
+            mutable SchemaChildren m_children;
+            mutable std::atomic<bool> m_children_built;
+
+            /// shared with the other leaves of the type, owned by the root
+            mutable SchemaValueType* m_type;
+            mutable std::atomic<bool> m_type_built;
+
+            mutable std::string m_path;
+            mutable std::atomic<bool> m_path_built;
+
+
+        };
+
+        ///
+        /// The SchemaNode wrapping a libyang schema node. The wrappers below the top level
+        /// nodes are created on demand, so those of the ancestors' children are created first
+        /// if need be. nullptr if the node is not part of the SchemaNode tree, e.g. a choice.
+        ///
+        SchemaNode* get_schema_node(const struct lys_node* node);
+
+        ///
+        /// Content-addressed store of model files shared by repositories across devices
+        /// and processes, see Repository::set_module_store. Each distinct file is kept once
+        /// under objects/, named after the checksum of its content, and indexed by model and
+        /// revision under modules/. Files are written aside and renamed into place, so that
+        /// concurrent writers never expose partial files.
+        ///
+        class ModuleStore
+        {
+        public:
+            explicit ModuleStore(const boost::filesystem::path& directory);
+
+            /// the data and the stored file of the model, false if it is not stored or the
+            /// file does not match its checksum. Models without a revision are never stored.
+            bool find(const std::string& name, const std::string& revision, std::string& data,
+                      boost::filesystem::path& stored) const;
+            /// stores the model, returns the stored file or an empty path on failure
+            boost::filesystem::path add(const std::string& name, const std::string& revision,
+                                        const std::string& data) const;
+            /// makes a stored file appear at file_path, hard linked when possible
+            static bool install(const boost::filesystem::path& stored, const boost::filesystem::path& file_path);
+
+        private:
+            boost::filesystem::path directory;
+        };
+
+        /// identifies the capabilities, from their modules, revisions, features and deviations,
+        /// and the content of the deviation module files in search_dir
+        std::string get_capabilities_fingerprint(const std::vector<Capability>& capabilities,
+                                                 const boost::filesystem::path& search_dir);
+
+        /// the next token of YANG text from pos, without quotes
+        std::string next_yang_token(const std::string& text, size_t& pos);
+        /// whether a statement with the given keyword starts at pos of YANG text
+        bool is_yang_keyword_at(const std::string& text, size_t pos, const std::string& keyword);
+
+        ///
+        /// Loads the modules of a lazily loaded root schema the first time a path names
+        /// them, see Repository::set_lazy_loading. A module is loaded along with the modules
+        /// deviating it and those augmenting it whose files are in the search directory.
+        ///
+        class LazyModuleLoader
+        {
+        public:
+            LazyModuleLoader(const boost::filesystem::path& search_dir, const std::vector<Capability>& capabilities);
 
-            std::unique_ptr<SchemaValueType> m_type;
+            /// the modules not loaded yet whose names prefix the segments of path
+            std::set<std::string> pending_in_path(const std::string& path);
+            /// the modules not loaded yet with nodes in a data payload: those of the namespaces
+            /// of an XML payload, or those qualifying the member names of a JSON one
+            std::set<std::string> pending_in_data(const char* data, bool json);
+            /// loads the modules along with the modules changing them, returns whether any was loaded
+            bool load(struct ly_ctx* ctx, const std::set<std::string>& modules);
 
+        private:
+            bool load_module(struct ly_ctx* ctx, const std::string& module_name);
+            void index_module_files();
+            std::string get_namespace_module(const std::string& ns);
 
+        private:
+            std::mutex loader_mutex;
+            boost::filesystem::path search_dir;
+            std::map<std::string, Capability> pending;
+            bool module_files_indexed;
+            /// module -> modules augmenting or deviating it
+            std::map<std::string, std::vector<std::string>> augmenters;
+            /// namespace -> module, for the pending modules with a file
+            std::map<std::string, std::string> namespaces;
+        };
+
+        ///
+        /// The SchemaValueTypes of the leaves of a context. The leaves of a typedef without
+        /// restrictions of their own share its type, leafrefs share the type of the leaf they
+        /// refer to and every identity has a single node, with the derived identities pointing
+        /// to their nodes.
+        ///
+        class SchemaValueTypeCache
+        {
+        public:
+            SchemaValueType* get_type(struct lys_node_leaf* leaf);
+            /// adds the identities derived in modules loaded since the identity nodes were
+            /// created; changes them in place, so no reader may be validating against them
+            void refresh_identities();
+
+        private:
+            SchemaValueType* get_type(struct lys_node_leaf* leaf, struct lys_type* type);
+            SchemaValueType* create_type(struct lys_node_leaf* leaf, struct lys_type* type);
+            SchemaValueType* add(std::unique_ptr<SchemaValueType> value_type);
+            SchemaValueIdentityType* get_identity(const struct lys_ident* ident);
+            SchemaValueType* get_identity_type(struct lys_ident** ident, unsigned int count);
+            void set_derived(const struct lys_ident* ident, SchemaValueIdentityType& identity_type);
+
+            /// the schema nodes create their types each under a lock of their own
+            std::mutex m_mutex;
+            std::vector<std::unique_ptr<SchemaValueType>> m_owned;
+            std::unordered_map<const struct lys_type*, SchemaValueType*> m_types;
+            std::unordered_map<const struct lys_ident*, SchemaValueIdentityType*> m_identities;
         };
 
         class RootSchemaNodeImpl : public RootSchemaNode
         {
         public:
             RootSchemaNodeImpl(struct ly_ctx* ctx) ;
+            RootSchemaNodeImpl(struct ly_ctx* ctx, std::unique_ptr<LazyModuleLoader> loader);
             virtual ~RootSchemaNodeImpl();
 
             std::vector<SchemaNode*> find(const std::string& path) const;
@@ -109,10 +257,66 @@ namespace ydk {
             Rpc* rpc(const std::string& path) const;
             SchemaValueType & type() const;
 
+            /// with lazy loading, loads the modules path refers to. Loading changes the context
+            /// and the schema tree, so it waits for the readers holding a SchemaReadLock and
+            /// throws if the calling thread holds one.
+            void load_modules(const std::string& path) const;
+            /// with lazy loading, loads the modules of the nodes in a data payload
+            void load_modules(const char* data, CodecService::Format format) const;
+
+            /// the schema node path leads to from start, or from the root if start is nullptr.
+            /// Paths found are indexed, so that looking them up again skips parsing them.
+            SchemaNode* find_node(const struct lys_node* start, const std::string& path) const;
 
             struct ly_ctx* m_ctx;
-            std::vector<std::unique_ptr<SchemaNode>> m_children;
+            /// grows as modules are loaded lazily
+            mutable SchemaChildren m_children;
+            std::unique_ptr<LazyModuleLoader> m_loader;
+            /// the types of the leaves, created as the schema nodes ask for them
+            mutable SchemaValueTypeCache m_value_types;
+
+        private:
+            typedef std::pair<const struct lys_node*, std::string> PathKey;
+            struct PathKeyHash
+            {
+                std::size_t operator()(const PathKey& key) const
+                {
+                    return std::hash<const void*>{}(key.first) ^ std::hash<std::string>{}(key.second);
+                }
+            };
+
+            /// paths are indexed as they are looked up, whether module qualified or not; only
+            /// paths found are, as lazily loaded modules may make others valid later
+            mutable std::mutex m_index_mutex;
+            mutable std::unordered_map<PathKey, SchemaNode*, PathKeyHash> m_path_index;
+
+            void load_pending_modules(const std::set<std::string>& modules, const std::string& what) const;
+
+            /// shared by the readers of the context, held exclusively by load_modules
+            mutable std::shared_timed_mutex m_schema_mutex;
+            friend class SchemaReadLock;
+        };
+
+        ///
+        /// Keeps lazily loaded modules from being loaded while the context of a root schema
+        /// is read: while schema nodes are looked up, data trees built or parsed against it.
+        /// Taken again by the same thread it does nothing, so entry points can nest. Modules a
+        /// path needs have to be loaded before taking it, a thread holding it cannot load any.
+        ///
+        class SchemaReadLock
+        {
+        public:
+            /// locks the root schema of schema_node
+            explicit SchemaReadLock(const SchemaNode* schema_node);
+            ~SchemaReadLock();
+
+            SchemaReadLock(const SchemaReadLock&) = delete;
+            SchemaReadLock& operator=(const SchemaReadLock&) = delete;
 
+            static bool is_held(const RootSchemaNodeImpl* root_schema);
+
+        private:
+            const RootSchemaNodeImpl* m_root_schema;
         };
 
 
@@ -135,6 +339,8 @@ namespace ydk {
             virtual const SchemaNode* schema() const;
 
             virtual std::string path() const;
+            virtual void append_path(std::string& buffer) const;
+            virtual void append_segment(std::string& buffer) const;
 
             // Create a new data node based on a simple XPath
             // The new node is normally inserted at the end, either as the last child of a parent.
@@ -196,6 +402,8 @@ namespace ydk {
             virtual const SchemaNode* schema() const;
 
             virtual std::string path() const;
+            virtual void append_path(std::string& buffer) const;
+            virtual void append_segment(std::string& buffer) const;
 
             virtual DataNode* create_filter(const std::string& path, const std::string& value);
             virtual DataNode* create(const std::string& path, const std::string& value);
@@ -234,16 +442,17 @@ namespace ydk {
 
             virtual SchemaNode* schema() const;
 
+            virtual void attach(const std::string& name, DataNode& data);
+
+            virtual std::vector<DataNode*> attached(const std::string& name) const;
+
 
             SchemaNodeImpl* m_sn;
             DataNode* m_input_dn;
+            std::map<std::string, std::vector<DataNode*>> m_attached;
 
 
         };
-
-        std::unique_ptr<SchemaValueType> create_schema_value_type(struct lys_node_leaf* leaf,
-        												  struct lys_type* type);
-        std::unique_ptr<SchemaValueType> create_schema_value_type(struct lys_node_leaf* leaf);
     }
 
 
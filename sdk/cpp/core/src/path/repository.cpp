@@ -25,7 +25,14 @@
 #include "path_private.hpp"
 #include "../ydk_yang.hpp"
 #include <boost/log/trivial.hpp>
+#include <algorithm>
+#include <cctype>
+#include <cstdint>
 #include <fstream>
+#include <iomanip>
+#include <mutex>
+#include <set>
+#include <sstream>
 
 namespace fs = boost::filesystem;
 
@@ -114,6 +121,47 @@ namespace ydk {
             }
         }
 
+        /* enlarge data by 2 bytes for flex */
+        static char* get_enlarged_data(const std::string& model_data)
+        {
+            auto data = model_data.c_str();
+            auto len = std::strlen(data);
+            char *enlarged_data = static_cast<char*>(std::malloc((len + 2) * sizeof *enlarged_data));
+            if (!enlarged_data) {
+                BOOST_THROW_EXCEPTION(std::bad_alloc{});
+            }
+            memcpy(enlarged_data, data, len);
+            enlarged_data[len] = enlarged_data[len + 1] = '\0';
+            return enlarged_data;
+        }
+
+        // the revision a model is kept under in the module store, empty if it cannot be told
+        // apart from the other revisions. A submodule included without a revision-date is the
+        // one of the revision of the module including it.
+        static std::string get_store_revision(const std::string& module_name, const std::string& module_revision,
+                                              bool submodule, const std::string& submodule_revision)
+        {
+            if(!submodule)
+                return module_revision;
+            if(!submodule_revision.empty())
+                return submodule_revision;
+            if(!module_revision.empty())
+                return module_name + "@" + module_revision;
+            return "";
+        }
+
+        // writes a downloaded model to the search directory, through the module store if there is one
+        static void save_model(const Repository& repo, const std::string& file_path,
+                               const std::string& name, const std::string& store_revision, const std::string& data)
+        {
+            if(repo.get_module_store()) {
+                fs::path stored = repo.get_module_store()->add(name, store_revision, data);
+                if(!stored.empty() && ModuleStore::install(stored, file_path))
+                    return;
+            }
+            sink_to_file(file_path, data);
+        }
+
         extern "C" char* get_module_callback(const char* module_name, const char* module_rev, const char *submod_name, const char *sub_rev,
         							   void* user_data, LYS_INFORMAT* format, void (**free_module_data)(void *model_data))
         {
@@ -159,17 +207,7 @@ namespace ydk {
                         yang_file.close();
 
                         *free_module_data = c_free_data;
-                        char *enlarged_data = nullptr;
-                        /* enlarge data by 2 bytes for flex */
-                        auto data = model_data.c_str();
-                        auto len = std::strlen(data);
-                        enlarged_data = static_cast<char*>(std::malloc((len + 2) * sizeof *enlarged_data));
-                        if (!enlarged_data) {
-                            BOOST_THROW_EXCEPTION(std::bad_alloc{});
-                        }
-                        memcpy(enlarged_data, data, len);
-                        enlarged_data[len] = enlarged_data[len + 1] = '\0';
-                        return enlarged_data;
+                        return get_enlarged_data(model_data);
                     } else {
                         BOOST_LOG_TRIVIAL(error) << "Cannot open file " << yang_file_path_str;
                         BOOST_THROW_EXCEPTION(YCPPIllegalStateError("Cannot open file"));
@@ -178,6 +216,19 @@ namespace ydk {
                 }
 
 
+                std::string store_name{submod_name ? submod_name : module_name};
+                std::string store_revision = get_store_revision(module_name, module_rev ? module_rev : "",
+                                                                submod_name != nullptr, sub_rev ? sub_rev : "");
+                if(repo->get_module_store()) {
+                    std::string model_data{};
+                    fs::path stored{};
+                    if(repo->get_module_store()->find(store_name, store_revision, model_data, stored)) {
+                        ModuleStore::install(stored, yang_file_path);
+                        *free_module_data = c_free_data;
+                        return get_enlarged_data(model_data);
+                    }
+                }
+
                 for(auto model_provider : repo->get_model_providers()) {
                 	std::string model_data{};
                 	if(submod_name)
@@ -192,19 +243,9 @@ namespace ydk {
                 	}
                     if(!model_data.empty()){
 
-                        sink_to_file(yang_file_path_str, model_data);
+                        save_model(*repo, yang_file_path_str, store_name, store_revision, model_data);
                         *free_module_data = c_free_data;
-                        char *enlarged_data = nullptr;
-                        /* enlarge data by 2 bytes for flex */
-                        auto data = model_data.c_str();
-                        auto len = std::strlen(data);
-                        enlarged_data = static_cast<char*>(std::malloc((len + 2) * sizeof *enlarged_data));
-                        if (!enlarged_data) {
-                            BOOST_THROW_EXCEPTION(std::bad_alloc{});
-                        }
-                        memcpy(enlarged_data, data, len);
-                        enlarged_data[len] = enlarged_data[len + 1] = '\0';
-                        return enlarged_data;
+                        return get_enlarged_data(model_data);
                     } else {
                         BOOST_LOG_TRIVIAL(trace) << "Cannot find model with module_name:- " << module_name << " module_rev:-" << (module_rev !=nullptr ? module_rev : "");
 //                        BOOST_THROW_EXCEPTION(YCPPIllegalStateError{"Cannot find model"});
@@ -216,6 +257,194 @@ namespace ydk {
 //            BOOST_THROW_EXCEPTION(YCPPIllegalStateError{"Cannot find model"});
             return {};
         }
+
+        // where get_module_callback looks for the model
+        static std::string get_model_file_path(const fs::path& dir, const std::string& name, const std::string& revision)
+        {
+            std::string file_path{dir.string()};
+            file_path += '/';
+            file_path += name;
+            if(!revision.empty()) {
+                file_path += "@";
+                file_path += revision;
+            }
+            file_path += ".yang";
+            return file_path;
+        }
+
+        // (name, revision-date) of the submodules a module includes
+        static std::vector<std::pair<std::string, std::string>> get_included_submodules(const std::string& text)
+        {
+            std::vector<std::pair<std::string, std::string>> submodules;
+            for(size_t pos = text.find("include"); pos != std::string::npos; pos = text.find("include", pos + 1))
+            {
+                if(!is_yang_keyword_at(text, pos, "include"))
+                    continue;
+                size_t cursor = pos + 7;
+                std::string name = next_yang_token(text, cursor);
+                std::string revision{};
+                while(cursor < text.size() && std::isspace(static_cast<unsigned char>(text[cursor])))
+                    ++cursor;
+                if(cursor < text.size() && text[cursor] == '{') {
+                    size_t body_end = text.find('}', cursor);
+                    size_t revision_pos = text.find("revision-date", cursor);
+                    if(revision_pos != std::string::npos && revision_pos < body_end) {
+                        cursor = revision_pos + 13;
+                        revision = next_yang_token(text, cursor);
+                    }
+                }
+                submodules.emplace_back(name, revision);
+            }
+            return submodules;
+        }
+
+        // Downloads the models of the capabilities which are not in the repository, along with
+        // the submodules they include, so that libyang finds them in place instead of getting
+        // them one at a time through get_module_callback. The model provider gets all the models
+        // missing at each level of includes in one go. Models which cannot be prefetched are
+        // left to get_module_callback.
+        static void prefetch_models(const Repository& repo, const std::vector<Capability>& capabilities)
+        {
+            auto model_providers = repo.get_model_providers();
+            if(model_providers.empty())
+                return;
+
+            StartupPhaseTimer timer{"prefetch-models"};
+            // a new context, to tell the modules built into libyang
+            std::unique_ptr<struct ly_ctx, void(*)(struct ly_ctx*)> builtin{ly_ctx_new(nullptr),
+                [](struct ly_ctx* c) { ly_ctx_destroy(c, nullptr); }};
+
+            // get_module_callback names the file of a submodule after the revision of the module
+            // including it, if it has one
+            struct MissingModel
+            {
+                std::string name;
+                std::string revision;
+                std::string file_path;
+                std::string store_revision;
+                // the module the submodules the model includes belong to
+                std::string module_name;
+                std::string module_revision;
+            };
+            std::set<std::string> requested{};
+            std::vector<MissingModel> missing{};
+            std::function<void(const std::string&, const std::string&, const std::string&, const std::string&, bool)> add_missing;
+            add_missing = [&](const std::string& name, const std::string& revision,
+                              const std::string& module_name, const std::string& module_revision, bool submodule) {
+                std::string file_path = get_model_file_path(repo.path, name, module_revision.empty() ? revision : module_revision);
+                if(fs::is_regular_file(file_path) || !requested.insert(file_path).second)
+                    return;
+                std::string store_revision = get_store_revision(module_name, module_revision, submodule, revision);
+                std::string data{};
+                fs::path stored{};
+                if(repo.get_module_store() && repo.get_module_store()->find(name, store_revision, data, stored)
+                   && ModuleStore::install(stored, file_path)) {
+                    for(auto & submodule : get_included_submodules(data))
+                        add_missing(submodule.first, submodule.second, module_name, module_revision, true);
+                    return;
+                }
+                missing.push_back(MissingModel{name, revision, file_path, store_revision, module_name, module_revision});
+            };
+
+            for(auto & c : capabilities)
+            {
+                if(c.module == "ietf-yang-library"
+                   || (builtin && ly_ctx_get_module(builtin.get(), c.module.c_str(), c.revision.empty() ? 0 : c.revision.c_str())))
+                    continue;
+                add_missing(c.module, c.revision, c.module, c.revision, false);
+            }
+
+            while(!missing.empty())
+            {
+                std::vector<MissingModel> models;
+                models.swap(missing);
+                BOOST_LOG_TRIVIAL(debug) << "Prefetching " << models.size() << " models from " << model_providers.front()->get_hostname_port();
+
+                std::vector<std::pair<std::string, std::string>> names;
+                for(auto & model : models)
+                    names.emplace_back(model.name, model.revision);
+                std::vector<std::string> model_data;
+                try {
+                    model_data = model_providers.front()->get_models(names, ModelProvider::Format::YANG);
+                } catch(const YCPPError& e) {
+                    BOOST_LOG_TRIVIAL(debug) << "Cannot prefetch models: " << e.what();
+                    return;
+                }
+
+                for(size_t i = 0; i < models.size() && i < model_data.size(); ++i)
+                {
+                    if(model_data[i].empty()) {
+                        BOOST_LOG_TRIVIAL(trace) << "Cannot prefetch model " << models[i].name;
+                        continue;
+                    }
+                    save_model(repo, models[i].file_path, models[i].name, models[i].store_revision, model_data[i]);
+                    for(auto & submodule : get_included_submodules(model_data[i]))
+                        add_missing(submodule.first, submodule.second, models[i].module_name, models[i].module_revision, true);
+                }
+            }
+        }
+
+        // downloads the missing deviation modules of the capabilities
+        static void prefetch_deviations(const Repository& repo, const std::vector<Capability>& capabilities)
+        {
+            std::vector<Capability> deviations;
+            for(auto & c : capabilities)
+            {
+                for(auto & deviation : c.deviations)
+                    deviations.emplace_back(deviation, "");
+            }
+            prefetch_models(repo, deviations);
+        }
+
+        std::string get_capabilities_fingerprint(const std::vector<Capability>& capabilities, const fs::path& search_dir)
+        {
+            std::vector<std::string> items;
+            std::set<std::string> deviations;
+            for(auto c : capabilities)
+            {
+                std::sort(c.features.begin(), c.features.end());
+                std::sort(c.deviations.begin(), c.deviations.end());
+                std::string item = c.module + "@" + c.revision + "|";
+                for(auto & feature : c.features)
+                    item += feature + ",";
+                item += "|";
+                for(auto & deviation : c.deviations)
+                    item += deviation + ",";
+                items.push_back(item);
+                deviations.insert(c.deviations.begin(), c.deviations.end());
+            }
+
+            // deviation modules are announced without a revision, so their files, with or
+            // without a revision in the name, can change under the same capabilities
+            boost::system::error_code ec;
+            if(!deviations.empty() && fs::is_directory(search_dir, ec))
+            {
+                for(fs::directory_iterator it{search_dir, ec}, end; !ec && it != end; it.increment(ec))
+                {
+                    std::string stem = it->path().stem().string();
+                    if(it->path().extension() != ".yang" || deviations.count(stem.substr(0, stem.find('@'))) == 0)
+                        continue;
+                    std::ifstream file{it->path().string(), std::ios::binary};
+                    items.push_back(it->path().filename().string() + "|"
+                                    + std::string{std::istreambuf_iterator<char>{file}, std::istreambuf_iterator<char>{}});
+                }
+            }
+            std::sort(items.begin(), items.end());
+
+            // FNV-1a, stable across processes and platforms unlike std::hash
+            std::uint64_t hash = 14695981039346656037ULL;
+            for(auto & item : items)
+            {
+                for(unsigned char c : item + "\n")
+                {
+                    hash ^= c;
+                    hash *= 1099511628211ULL;
+                }
+            }
+            std::ostringstream fingerprint{};
+            fingerprint << std::hex << std::setw(16) << std::setfill('0') << hash;
+            return fingerprint.str();
+        }
     }
 
 }
@@ -223,15 +452,12 @@ namespace ydk {
 ydk::path::RootSchemaNode*
 ydk::path::Repository::create_root_schema(const std::vector<path::Capability> & capabilities)
 {
-	if(using_temp_directory)
-	{
-		for(auto model_provider : get_model_providers()) {
-			path+="/"+model_provider->get_hostname_port();
-			boost::filesystem::create_directory(path);
-			BOOST_LOG_TRIVIAL(debug) << "Path where models are to be downloaded: " << path.string();
-			break;
-		}
-	}
+    StartupPhaseTimer timer{"create-root-schema"};
+    if(!lazy_loading)
+    {
+        prefetch_models(*this, capabilities);
+    }
+
     std::string path_str = path.string();
     BOOST_LOG_TRIVIAL(trace) << "Creating libyang context in path "<<path_str;
     struct ly_ctx* ctx = ly_ctx_new(path_str.c_str());
@@ -246,6 +472,12 @@ ydk::path::Repository::create_root_schema(const std::vector<path::Capability> &
         ly_ctx_set_module_clb(ctx, get_module_callback, this);
     }
 
+    if(lazy_loading)
+    {
+        ly_verb(LY_LLVRB); // enable libyang logging after model download has completed
+        return new RootSchemaNodeImpl{ctx, std::make_unique<LazyModuleLoader>(path, capabilities)};
+    }
+
     for (auto c : capabilities)
     {
         if(c.module == "ietf-yang-library")
@@ -254,6 +486,7 @@ ydk::path::Repository::create_root_schema(const std::vector<path::Capability> &
         auto p = ly_ctx_get_module(ctx, c.module.c_str(), c.revision.empty() ? 0 : c.revision.c_str());
 
         if(!p) {
+            StartupPhaseTimer module_timer{"load-module", c.module};
             p = ly_ctx_load_module(ctx, c.module.c_str(), c.revision.empty() ? 0 : c.revision.c_str());
         } else {
             BOOST_LOG_TRIVIAL(trace) << "Cache hit module name:-" << c.module;
@@ -273,6 +506,96 @@ ydk::path::Repository::create_root_schema(const std::vector<path::Capability> &
     return rs;
 }
 
+namespace ydk {
+    namespace path {
+        // root schemas handed out by get_shared_root_schema, by search path and capability fingerprint
+        struct SharedRootSchema
+        {
+            // held while the schema is created, so it is only created once
+            std::mutex create_mutex;
+            std::weak_ptr<RootSchemaNode> schema;
+        };
+
+        static std::mutex shared_root_schemas_mutex;
+        static std::map<std::string, std::shared_ptr<SharedRootSchema>> shared_root_schemas;
+
+        static std::shared_ptr<SharedRootSchema> get_shared_root_schema_slot(const std::string& key)
+        {
+            std::lock_guard<std::mutex> lock{shared_root_schemas_mutex};
+            for(auto it = shared_root_schemas.begin(); it != shared_root_schemas.end();) {
+                if(it->first != key && it->second->schema.expired() && it->second.use_count() == 1) {
+                    it = shared_root_schemas.erase(it);
+                } else {
+                    ++it;
+                }
+            }
+            auto & slot = shared_root_schemas[key];
+            if(!slot) {
+                slot = std::make_shared<SharedRootSchema>();
+            }
+            return slot;
+        }
+    }
+}
+
+std::shared_ptr<ydk::path::RootSchemaNode>
+ydk::path::Repository::get_shared_root_schema(const std::vector<path::Capability> & capabilities)
+{
+    //a lazily loaded schema grows as it is used, so it is not shared
+    if(lazy_loading) {
+        return std::shared_ptr<RootSchemaNode>(create_root_schema(capabilities));
+    }
+
+    //the modules are read from the search path, and deviations can change there under the same
+    //capabilities; the missing ones are downloaded first so the key covers what the schema is parsed with
+    prefetch_deviations(*this, capabilities);
+    auto slot = get_shared_root_schema_slot(path.string() + "|" + get_capabilities_fingerprint(capabilities, path));
+    std::lock_guard<std::mutex> lock{slot->create_mutex};
+    auto schema = slot->schema.lock();
+    if(schema) {
+        BOOST_LOG_TRIVIAL(debug) << "Sharing root schema with " << schema.use_count() - 1 << " other owners";
+        return schema;
+    }
+
+    schema = std::shared_ptr<RootSchemaNode>(create_root_schema(capabilities));
+    //the module callback refers to this repository, which the other owners may outlive
+    auto rs_impl = dynamic_cast<RootSchemaNodeImpl*>(schema.get());
+    if(rs_impl) {
+        ly_ctx_set_module_clb(rs_impl->m_ctx, nullptr, nullptr);
+    }
+    slot->schema = schema;
+    return schema;
+}
+
+void
+ydk::path::Repository::set_lazy_loading(bool lazy)
+{
+    lazy_loading = lazy;
+}
+
+void
+ydk::path::Repository::set_module_store(const std::string& store_dir)
+{
+    boost::system::error_code ec;
+    fs::create_directories(store_dir, ec);
+    if(ec || !fs::is_directory(store_dir)) {
+        BOOST_LOG_TRIVIAL(error) << "Cannot create module store directory " << store_dir;
+        BOOST_THROW_EXCEPTION(YCPPInvalidArgumentError{"Cannot create module store directory " + store_dir});
+    }
+    //anyone able to write to the store decides what the models of every user of it are
+    if((fs::status(store_dir, ec).permissions() & fs::others_write) != 0) {
+        BOOST_LOG_TRIVIAL(error) << "Module store directory " << store_dir << " is writable by others";
+        BOOST_THROW_EXCEPTION(YCPPInvalidArgumentError{"Module store directory " + store_dir + " is writable by others"});
+    }
+    module_store = std::make_shared<ModuleStore>(fs::path{store_dir});
+}
+
+ydk::path::ModuleStore*
+ydk::path::Repository::get_module_store() const
+{
+    return module_store.get();
+}
+
 ///
 /// @brief Adds a model provider.
 ///
@@ -286,6 +609,14 @@ ydk::path::Repository::create_root_schema(const std::vector<path::Capability> &
 void
 ydk::path::Repository::add_model_provider(ydk::path::ModelProvider* model_provider)
 {
+    //a repository without a search directory of its own downloads the models of the first device
+    //into a directory of that device, before anything is looked up in it
+    if(using_temp_directory && model_providers.empty())
+    {
+        path = fs::temp_directory_path() / model_provider->get_hostname_port();
+        fs::create_directory(path);
+        BOOST_LOG_TRIVIAL(debug) << "Path where models are to be downloaded: " << path.string();
+    }
     model_providers.push_back(model_provider);
 }
 
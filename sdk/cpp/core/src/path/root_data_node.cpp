@@ -51,6 +51,17 @@ ydk::path::RootDataImpl::path() const
     return m_schema->path();
 }
 
+void
+ydk::path::RootDataImpl::append_path(std::string& buffer) const
+{
+    buffer+=m_schema->path();
+}
+
+void
+ydk::path::RootDataImpl::append_segment(std::string&) const
+{
+}
+
 ydk::path::DataNode*
 ydk::path::RootDataImpl::create_filter(const std::string& path, const std::string& value)
 {
@@ -74,6 +85,14 @@ ydk::path::RootDataImpl::create(const std::string& path, const std::string& valu
         BOOST_LOG_TRIVIAL(error) << "Path " << path << " starts with /";
         BOOST_THROW_EXCEPTION(YCPPInvalidArgumentError{"Path starts with /"});
     }
+
+    auto root_schema = dynamic_cast<const RootSchemaNodeImpl*>(m_schema);
+    if(root_schema)
+    {
+        root_schema->load_modules(path);
+    }
+    SchemaReadLock read_lock{m_schema};
+
     std::vector<std::string> segments = segmentalize(path);
     if(segments.size()<=0)
     {
@@ -69,17 +69,37 @@ ydk::path::RootSchemaNode::keys() const
 /////////////////////////////////////////////////////////////////////////////////////
 // class RootSchemaNodeImpl
 /////////////////////////////////////////////////////////////////////////////////////
+namespace ydk {
+    namespace path {
+        static void add_new_children(SchemaNodeImpl& parent);
+
+        static const std::size_t MAX_PATH_INDEX_SIZE = 1 << 16;
+
+        /// the root schemas the current thread holds a SchemaReadLock on
+        static thread_local std::vector<const RootSchemaNodeImpl*> held_read_locks;
+    }
+}
+
+ydk::path::RootSchemaNodeImpl::RootSchemaNodeImpl(struct ly_ctx* ctx, std::unique_ptr<LazyModuleLoader> loader)
+    : RootSchemaNodeImpl{ctx}
+{
+    m_loader = std::move(loader);
+}
+
 ydk::path::RootSchemaNodeImpl::RootSchemaNodeImpl(struct ly_ctx* ctx) : m_ctx{ctx}
 {
     //populate the tree
+    std::vector<std::unique_ptr<SchemaNode>> children;
     uint32_t idx = 0;
     while( auto p = ly_ctx_get_module_iter(ctx, &idx)) {
+        StartupPhaseTimer timer{"build-schema-tree", p->name};
         const struct lys_node *last = nullptr;
         while( auto q = lys_getnext(last, nullptr, p, 0)) {
-            m_children.push_back(std::make_unique<SchemaNodeImpl>(this, const_cast<struct lys_node*>(q)));
+            children.push_back(std::make_unique<SchemaNodeImpl>(this, const_cast<struct lys_node*>(q)));
             last = q;
         }
     }
+    m_children.append(std::move(children));
 
 }
 
@@ -91,6 +111,81 @@ ydk::path::RootSchemaNodeImpl::~RootSchemaNodeImpl()
     }
 }
 
+void
+ydk::path::RootSchemaNodeImpl::load_modules(const std::string& path) const
+{
+    if(m_loader) {
+        load_pending_modules(m_loader->pending_in_path(path), path);
+    }
+}
+
+void
+ydk::path::RootSchemaNodeImpl::load_modules(const char* data, CodecService::Format format) const
+{
+    if(m_loader) {
+        load_pending_modules(m_loader->pending_in_data(data, format == CodecService::Format::JSON), "data");
+    }
+}
+
+void
+ydk::path::RootSchemaNodeImpl::load_pending_modules(const std::set<std::string>& modules, const std::string& what) const
+{
+    if(modules.empty()) {
+        return;
+    }
+    if(SchemaReadLock::is_held(this)) {
+        //waiting for the readers would wait for this thread
+        std::ostringstream os;
+        os << "Cannot load the modules of " << what << " while the schema is being read on the same thread";
+        BOOST_LOG_TRIVIAL(error) << os.str();
+        BOOST_THROW_EXCEPTION(YCPPIllegalStateError{os.str()});
+    }
+
+    std::unique_lock<std::shared_timed_mutex> lock{m_schema_mutex};
+    if(!m_loader->load(m_ctx, modules)) {
+        return;
+    }
+    //the new modules may derive identities from those of the loaded ones
+    m_value_types.refresh_identities();
+
+    StartupPhaseTimer timer{"build-schema-tree", what};
+    //the new modules bring top level nodes and, through augments, nodes below existing ones
+    std::vector<std::unique_ptr<SchemaNode>> children;
+    uint32_t idx = 0;
+    while( auto p = ly_ctx_get_module_iter(m_ctx, &idx)) {
+        const struct lys_node *last = nullptr;
+        while( auto q = lys_getnext(last, nullptr, p, 0)) {
+            if(q->priv) {
+                add_new_children(*reinterpret_cast<SchemaNodeImpl*>(q->priv));
+            } else {
+                children.push_back(std::make_unique<SchemaNodeImpl>(this, const_cast<struct lys_node*>(q)));
+            }
+            last = q;
+        }
+    }
+    m_children.append(std::move(children));
+}
+
+static void
+ydk::path::add_new_children(SchemaNodeImpl& parent)
+{
+    //children not created yet are created along with the new ones when first asked for
+    if(!parent.children_built() || parent.m_node->nodetype == LYS_LEAF || parent.m_node->nodetype == LYS_LEAFLIST) {
+        return;
+    }
+    std::vector<std::unique_ptr<SchemaNode>> children;
+    const struct lys_node *last = nullptr;
+    while( auto q = lys_getnext(last, parent.m_node, nullptr, 0)) {
+        if(q->priv) {
+            add_new_children(*reinterpret_cast<SchemaNodeImpl*>(q->priv));
+        } else {
+            children.emplace_back(std::make_unique<SchemaNodeImpl>(&parent, const_cast<struct lys_node*>(q)));
+        }
+        last = q;
+    }
+    parent.m_children.append(std::move(children));
+}
+
 std::vector<ydk::path::SchemaNode*>
 ydk::path::RootSchemaNodeImpl::find(const std::string& path) const
 {
@@ -98,6 +193,8 @@ ydk::path::RootSchemaNodeImpl::find(const std::string& path) const
         BOOST_LOG_TRIVIAL(error) << "path is empty";
         BOOST_THROW_EXCEPTION(YCPPInvalidArgumentError{"path is empty"});
     }
+    load_modules(path);
+    SchemaReadLock read_lock{this};
 
     //has to be a relative path
     if(path.at(0) == '/') {
@@ -110,22 +207,48 @@ ydk::path::RootSchemaNodeImpl::find(const std::string& path) const
     std::string full_path{"/"};
     full_path+=path;
 
-    const struct lys_node* found_node = ly_ctx_get_node(m_ctx, nullptr, full_path.c_str());
+    auto p = find_node(nullptr, full_path);
+    if(p) {
+        ret.push_back(p);
+    }
 
-    if (found_node){
-        auto p = reinterpret_cast<SchemaNode*>(found_node->priv);
-        if(p) {
-            ret.push_back(p);
+    return ret;
+}
+
+ydk::path::SchemaNode*
+ydk::path::RootSchemaNodeImpl::find_node(const struct lys_node* start, const std::string& path) const
+{
+    PathKey key{start, path};
+    {
+        std::lock_guard<std::mutex> lock{m_index_mutex};
+        auto indexed = m_path_index.find(key);
+        if(indexed != m_path_index.end()) {
+            return indexed->second;
         }
     }
 
-    return ret;
+    const struct lys_node* found_node = ly_ctx_get_node(m_ctx, start, path.c_str());
+    if(!found_node) {
+        return nullptr;
+    }
+    auto p = get_schema_node(found_node);
+    if(p) {
+        std::lock_guard<std::mutex> lock{m_index_mutex};
+        //bounded, paths are not expected to be made up on the fly but nothing stops it
+        if(m_path_index.size() >= MAX_PATH_INDEX_SIZE) {
+            m_path_index.clear();
+        }
+        m_path_index.emplace(std::move(key), p);
+    }
+    return p;
 }
 
 const std::vector<std::unique_ptr<ydk::path::SchemaNode>> &
 ydk::path::RootSchemaNodeImpl::children() const
 {
-    return m_children;
+    //waits for a load in progress, the modules loaded later publish a new vector
+    SchemaReadLock read_lock{this};
+    return m_children.get();
 }
 
 ydk::path::DataNode*
@@ -137,6 +260,8 @@ ydk::path::RootSchemaNodeImpl::create(const std::string& path) const
 ydk::path::DataNode*
 ydk::path::RootSchemaNodeImpl::create(const std::string& path, const std::string& value) const
 {
+    load_modules(path);
+    SchemaReadLock read_lock{this};
     RootDataImpl* rd = new RootDataImpl{this, m_ctx, "/"};
 
     if (rd){
@@ -149,6 +274,8 @@ ydk::path::RootSchemaNodeImpl::create(const std::string& path, const std::string
 ydk::path::DataNode*
 ydk::path::RootSchemaNodeImpl::from_xml(const std::string& xml) const
 {
+    load_modules(xml.c_str(), CodecService::Format::XML);
+    SchemaReadLock read_lock{this};
     struct lyd_node *root = lyd_parse_mem(m_ctx, xml.c_str(), LYD_XML, 0);
     RootDataImpl* rd = new RootDataImpl{this, m_ctx, "/"};
     DataNodeImpl* nodeImpl = new DataNodeImpl{rd,root};
@@ -166,6 +293,7 @@ ydk::path::RootSchemaNodeImpl::rpc(const std::string& path) const
     if(c.empty()){
         BOOST_THROW_EXCEPTION(YCPPInvalidArgumentError{"Path is invalid"});
     }
+    SchemaReadLock read_lock{this};
 
     bool found = false;
     SchemaNode* rpc_sn = nullptr;
@@ -198,3 +326,33 @@ ydk::path::RootSchemaNodeImpl::type() const
 	auto ignored = std::make_unique<SchemaValueBoolType>();
     return *ignored;
 }
+
+/////////////////////////////////////////////////////////////////////////////////////
+// class SchemaReadLock
+/////////////////////////////////////////////////////////////////////////////////////
+ydk::path::SchemaReadLock::SchemaReadLock(const SchemaNode* schema_node)
+    : m_root_schema{schema_node ? dynamic_cast<const RootSchemaNodeImpl*>(schema_node->root()) : nullptr}
+{
+    //without lazy loading the context does not change once created
+    if(!m_root_schema || !m_root_schema->m_loader || is_held(m_root_schema)) {
+        m_root_schema = nullptr;
+        return;
+    }
+    m_root_schema->m_schema_mutex.lock_shared();
+    held_read_locks.push_back(m_root_schema);
+}
+
+ydk::path::SchemaReadLock::~SchemaReadLock()
+{
+    if(!m_root_schema) {
+        return;
+    }
+    held_read_locks.erase(std::find(held_read_locks.begin(), held_read_locks.end(), m_root_schema));
+    m_root_schema->m_schema_mutex.unlock_shared();
+}
+
+bool
+ydk::path::SchemaReadLock::is_held(const RootSchemaNodeImpl* root_schema)
+{
+    return std::find(held_read_locks.begin(), held_read_locks.end(), root_schema) != held_read_locks.end();
+}
@@ -33,6 +33,20 @@ ydk::path::Rpc::~Rpc()
 {
 
 }
+
+void
+ydk::path::Rpc::attach(const std::string& name, DataNode&)
+{
+    BOOST_LOG_TRIVIAL(error) << "Rpc does not support attaching data to " << name;
+    BOOST_THROW_EXCEPTION(YCPPOperationNotSupportedError{"Rpc does not support attaching data to " + name});
+}
+
+std::vector<ydk::path::DataNode*>
+ydk::path::Rpc::attached(const std::string&) const
+{
+    return {};
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 // class RpcImpl
 ////////////////////////////////////////////////////////////////////////////////
@@ -41,7 +55,7 @@ ydk::path::Rpc::~Rpc()
 ydk::path::RpcImpl::RpcImpl(SchemaNodeImpl* sn, struct ly_ctx* ctx) : m_sn{sn}
 {
 
-    struct lyd_node* dnode = lyd_new_path(nullptr, ctx, sn->path().c_str(), (void*)"", LYD_ANYDATA_SXML, 0);
+    struct lyd_node* dnode = lyd_new_path(nullptr, ctx, sn->cached_path().c_str(), (void*)"", LYD_ANYDATA_SXML, 0);
 
     if(!dnode){
         BOOST_LOG_TRIVIAL(error) << "Cannot find DataNode with path " << sn->path();
@@ -79,3 +93,19 @@ ydk::path::RpcImpl::schema() const
 {
     return m_sn;
 }
+
+void
+ydk::path::RpcImpl::attach(const std::string& name, DataNode& data)
+{
+    m_attached[name].push_back(&data);
+}
+
+std::vector<ydk::path::DataNode*>
+ydk::path::RpcImpl::attached(const std::string& name) const
+{
+    auto found = m_attached.find(name);
+    if(found == m_attached.end()){
+        return {};
+    }
+    return found->second;
+}
@@ -22,6 +22,8 @@
 //////////////////////////////////////////////////////////////////
 
 
+#include <cstring>
+
 #include "path_private.hpp"
 #include <boost/log/trivial.hpp>
 
@@ -38,23 +40,68 @@ ydk::path::SchemaNode::~SchemaNode()
 /////////////////////////////////////////////////////////////////////
 // ydk::SchemaNodeImpl
 ////////////////////////////////////////////////////////////////////
-ydk::path::SchemaNodeImpl::SchemaNodeImpl(const SchemaNode* parent, struct lys_node* node):m_parent{parent}, m_node{node}, m_children{}, m_type{nullptr}
-{
-    node->priv = this;
-    if(node->nodetype != LYS_LEAF && node->nodetype != LYS_LEAFLIST) {
+namespace ydk {
+    namespace path {
+        // guards creating the children and types of all schema nodes, which happens once per
+        // node and is over quickly, so that schemas can be used from several threads
+        static std::mutex materialize_mutex;
 
-        const struct lys_node *last = nullptr;
+        static const std::vector<std::unique_ptr<SchemaNode>> no_children{};
 
-        while( auto q = lys_getnext(last, node, nullptr, 0)) {
-            m_children.emplace_back(std::make_unique<SchemaNodeImpl>(this,const_cast<struct lys_node*>(q)));
-            last = q;
+        static void* get_priv(const struct lys_node* node)
+        {
+            return __atomic_load_n(&node->priv, __ATOMIC_ACQUIRE);
         }
-    } else {
-        struct lys_node_leaf* node_leaf = reinterpret_cast<struct lys_node_leaf*>(m_node);
-        m_type = ydk::path::create_schema_value_type(node_leaf);
+    }
+}
+
+ydk::path::SchemaChildren::SchemaChildren() : m_current{&no_children}, m_published{}
+{
+}
 
+ydk::path::SchemaChildren::~SchemaChildren()
+{
+    //the nodes are owned by the last vector published, the others refer to them
+    for(std::size_t i = 0; i + 1 < m_published.size(); ++i) {
+        for(auto & child : *m_published[i]) {
+            child.release();
+        }
     }
+}
 
+const std::vector<std::unique_ptr<ydk::path::SchemaNode>>&
+ydk::path::SchemaChildren::get() const
+{
+    return *m_current.load(std::memory_order_acquire);
+}
+
+void
+ydk::path::SchemaChildren::append(std::vector<std::unique_ptr<SchemaNode>> added)
+{
+    if(added.empty()) {
+        return;
+    }
+    //nothing throws once the nodes are shared by two vectors
+    m_published.reserve(m_published.size() + 1);
+    auto & current = *m_current.load(std::memory_order_relaxed);
+    auto next = std::make_unique<std::vector<std::unique_ptr<SchemaNode>>>();
+    next->reserve(current.size() + added.size());
+    for(auto & child : current) {
+        next->emplace_back(child.get());
+    }
+    for(auto & child : added) {
+        next->push_back(std::move(child));
+    }
+    m_current.store(next.get(), std::memory_order_release);
+    m_published.push_back(std::move(next));
+}
+
+ydk::path::SchemaNodeImpl::SchemaNodeImpl(const SchemaNode* parent, struct lys_node* node):m_parent{parent}, m_node{node}, m_children{}, m_children_built{false}, m_type{nullptr}, m_type_built{false}, m_path{}, m_path_built{false}
+{
+    if(node->nodetype == LYS_LEAF || node->nodetype == LYS_LEAFLIST) {
+        m_children_built = true;
+    }
+    __atomic_store_n(&node->priv, static_cast<void*>(this), __ATOMIC_RELEASE);
 }
 
 ydk::path::SchemaNodeImpl::~SchemaNodeImpl()
@@ -64,36 +111,43 @@ ydk::path::SchemaNodeImpl::~SchemaNodeImpl()
 std::string
 ydk::path::SchemaNodeImpl::path() const
 {
-    std::string ret{};
-
-    std::vector<std::string> segments;
-
-    struct lys_node* cur_node = m_node;
-    struct lys_module* module = nullptr;
-
-    while(cur_node != nullptr){
-	module = cur_node->module;
-	if (!cur_node->parent || cur_node->parent->module != module) {
-		//qualify with module name
-
-		std::string segname {module->name};
-		segname+=':';
-		segname+=cur_node->name;
-		segments.push_back(segname);
-	} else {
-		segments.push_back(cur_node->name);
-	}
-	cur_node = cur_node->parent;
+    return cached_path();
+}
+
+const std::string&
+ydk::path::SchemaNodeImpl::cached_path() const
+{
+    if(m_path_built.load(std::memory_order_acquire)) {
+        return m_path;
     }
 
-    std::reverse(segments.begin(), segments.end());
-    for ( auto seg : segments ) {
-	ret+="/";
-	ret+=seg;
+    std::lock_guard<std::mutex> guard(materialize_mutex);
+    if(m_path_built.load(std::memory_order_relaxed)) {
+        return m_path;
+    }
+
+    std::vector<const struct lys_node*> nodes;
+    std::size_t length = 0;
 
+    for(const struct lys_node* cur_node = m_node; cur_node != nullptr; cur_node = cur_node->parent) {
+        nodes.push_back(cur_node);
+        length += std::strlen(cur_node->module->name) + std::strlen(cur_node->name) + 2;
     }
 
-    return ret;
+    m_path.reserve(length);
+    for(auto it = nodes.rbegin(); it != nodes.rend(); ++it) {
+        const struct lys_node* cur_node = *it;
+        m_path+='/';
+        if (!cur_node->parent || cur_node->parent->module != cur_node->module) {
+            //qualify with module name
+            m_path+=cur_node->module->name;
+            m_path+=':';
+        }
+        m_path+=cur_node->name;
+    }
+
+    m_path_built.store(true, std::memory_order_release);
+    return m_path;
 }
 
 std::vector<ydk::path::SchemaNode*>
@@ -113,17 +167,31 @@ ydk::path::SchemaNodeImpl::find(const std::string& path) const
     }
 
     std::vector<SchemaNode*> ret;
-    struct ly_ctx* ctx = m_node->module->ctx;
+    SchemaNode* p = nullptr;
 
-    const struct lys_node* found_node = ly_ctx_get_node(ctx, m_node, path.c_str());
+    auto root_schema = dynamic_cast<const RootSchemaNodeImpl*>(root());
+    if(root_schema)
+    {
+        root_schema->load_modules(path);
+    }
+    SchemaReadLock read_lock{this};
+    if(root_schema)
+    {
+        p = root_schema->find_node(m_node, path);
+    }
+    else
+    {
+        struct ly_ctx* ctx = m_node->module->ctx;
+        const struct lys_node* found_node = ly_ctx_get_node(ctx, m_node, path.c_str());
+        if (found_node)
+        {
+            p = get_schema_node(found_node);
+        }
+    }
 
-    if (found_node)
+    if(p)
     {
-		auto p = reinterpret_cast<SchemaNode*>(found_node->priv);
-		if(p)
-		{
-			ret.push_back(p);
-		}
+        ret.push_back(p);
     }
 
     return ret;
@@ -138,8 +206,50 @@ ydk::path::SchemaNodeImpl::parent() const noexcept
 const std::vector<std::unique_ptr<ydk::path::SchemaNode>> &
 ydk::path::SchemaNodeImpl::children() const
 {
+    //modules loaded later publish a new vector, the one returned is left as it is
+    SchemaReadLock read_lock{this};
+    if(!m_children_built.load(std::memory_order_acquire)) {
+        std::lock_guard<std::mutex> lock{materialize_mutex};
+        if(!m_children_built.load(std::memory_order_relaxed)) {
+            std::vector<std::unique_ptr<SchemaNode>> children;
+            const struct lys_node *last = nullptr;
+            while( auto q = lys_getnext(last, m_node, nullptr, 0)) {
+                children.emplace_back(std::make_unique<SchemaNodeImpl>(this, const_cast<struct lys_node*>(q)));
+                last = q;
+            }
+            m_children.append(std::move(children));
+            m_children_built.store(true, std::memory_order_release);
+        }
+    }
+    return m_children.get();
+}
 
-    return m_children;
+bool
+ydk::path::SchemaNodeImpl::children_built() const
+{
+    return m_children_built.load(std::memory_order_acquire);
+}
+
+ydk::path::SchemaNode*
+ydk::path::get_schema_node(const struct lys_node* node)
+{
+    while(!get_priv(node)) {
+        //the closest ancestor with a wrapper creates those of its children, which may
+        //be the node itself or bring the next ancestor down
+        const struct lys_node* ancestor = lys_parent(node);
+        while(ancestor && !get_priv(ancestor)) {
+            ancestor = lys_parent(ancestor);
+        }
+        if(!ancestor) {
+            return nullptr;
+        }
+        auto impl = reinterpret_cast<SchemaNodeImpl*>(get_priv(ancestor));
+        if(impl->children_built()) {
+            return nullptr;
+        }
+        impl->children();
+    }
+    return reinterpret_cast<SchemaNode*>(get_priv(node));
 }
 
 const ydk::path::SchemaNode*
@@ -234,7 +344,7 @@ ydk::path::SchemaNodeImpl::keys() const
         }
         struct lys_node_list *slist = (struct lys_node_list *)m_node;
         for(uint8_t i=0; i < slist->keys_size; ++i) {
-            SchemaNode* sn = reinterpret_cast<SchemaNode*>(slist->keys[i]->priv);
+            SchemaNode* sn = get_schema_node(reinterpret_cast<struct lys_node*>(slist->keys[i]));
             if(sn != nullptr){
                 stmts.push_back(sn->statement());
             }
@@ -249,7 +359,16 @@ ydk::path::SchemaNodeImpl::keys() const
 ydk::path::SchemaValueType &
 ydk::path::SchemaNodeImpl::type() const
 {
-
+    if(!m_type_built.load(std::memory_order_acquire)) {
+        std::lock_guard<std::mutex> lock{materialize_mutex};
+        if(!m_type_built.load(std::memory_order_relaxed)) {
+            auto root_schema = dynamic_cast<const RootSchemaNodeImpl*>(root());
+            if(root_schema && (m_node->nodetype == LYS_LEAF || m_node->nodetype == LYS_LEAFLIST)) {
+                m_type = root_schema->m_value_types.get_type(reinterpret_cast<struct lys_node_leaf*>(m_node));
+            }
+            m_type_built.store(true, std::memory_order_release);
+        }
+    }
     return *m_type;
 }
 
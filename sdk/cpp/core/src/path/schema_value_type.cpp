@@ -22,6 +22,8 @@
 //////////////////////////////////////////////////////////////////
 
 
+#include <pcre.h>
+
 #include "path_private.hpp"
 #include <boost/log/trivial.hpp>
 
@@ -256,6 +258,243 @@ ydk::path::SchemaValueInstanceIdType::validate(const std::string& value) const
     return diag;
 }
 
+////////////////////////////////////////////////////////////////////
+// ydk::path::SchemaValueStringType::Pattern
+////////////////////////////////////////////////////////////////////////
+
+namespace ydk {
+    namespace path {
+        // the Unicode blocks XSD names with \p{IsBlock}, which PCRE does not know, as ranges
+        static const std::map<std::string, std::string> UNICODE_BLOCKS {
+            {"BasicLatin", "\\x{0000}-\\x{007F}"},
+            {"Latin-1Supplement", "\\x{0080}-\\x{00FF}"},
+            {"LatinExtended-A", "\\x{0100}-\\x{017F}"},
+            {"LatinExtended-B", "\\x{0180}-\\x{024F}"},
+            {"IPAExtensions", "\\x{0250}-\\x{02AF}"},
+            {"SpacingModifierLetters", "\\x{02B0}-\\x{02FF}"},
+            {"CombiningDiacriticalMarks", "\\x{0300}-\\x{036F}"},
+            {"Greek", "\\x{0370}-\\x{03FF}"},
+            {"Cyrillic", "\\x{0400}-\\x{04FF}"},
+            {"Armenian", "\\x{0530}-\\x{058F}"},
+            {"Hebrew", "\\x{0590}-\\x{05FF}"},
+            {"Arabic", "\\x{0600}-\\x{06FF}"},
+            {"Syriac", "\\x{0700}-\\x{074F}"},
+            {"Thaana", "\\x{0780}-\\x{07BF}"},
+            {"Devanagari", "\\x{0900}-\\x{097F}"},
+            {"Bengali", "\\x{0980}-\\x{09FF}"},
+            {"Gurmukhi", "\\x{0A00}-\\x{0A7F}"},
+            {"Gujarati", "\\x{0A80}-\\x{0AFF}"},
+            {"Oriya", "\\x{0B00}-\\x{0B7F}"},
+            {"Tamil", "\\x{0B80}-\\x{0BFF}"},
+            {"Telugu", "\\x{0C00}-\\x{0C7F}"},
+            {"Kannada", "\\x{0C80}-\\x{0CFF}"},
+            {"Malayalam", "\\x{0D00}-\\x{0D7F}"},
+            {"Sinhala", "\\x{0D80}-\\x{0DFF}"},
+            {"Thai", "\\x{0E00}-\\x{0E7F}"},
+            {"Lao", "\\x{0E80}-\\x{0EFF}"},
+            {"Tibetan", "\\x{0F00}-\\x{0FFF}"},
+            {"Myanmar", "\\x{1000}-\\x{109F}"},
+            {"Georgian", "\\x{10A0}-\\x{10FF}"},
+            {"HangulJamo", "\\x{1100}-\\x{11FF}"},
+            {"Ethiopic", "\\x{1200}-\\x{137F}"},
+            {"Cherokee", "\\x{13A0}-\\x{13FF}"},
+            {"UnifiedCanadianAboriginalSyllabics", "\\x{1400}-\\x{167F}"},
+            {"Ogham", "\\x{1680}-\\x{169F}"},
+            {"Runic", "\\x{16A0}-\\x{16FF}"},
+            {"Khmer", "\\x{1780}-\\x{17FF}"},
+            {"Mongolian", "\\x{1800}-\\x{18AF}"},
+            {"LatinExtendedAdditional", "\\x{1E00}-\\x{1EFF}"},
+            {"GreekExtended", "\\x{1F00}-\\x{1FFF}"},
+            {"GeneralPunctuation", "\\x{2000}-\\x{206F}"},
+            {"SuperscriptsandSubscripts", "\\x{2070}-\\x{209F}"},
+            {"CurrencySymbols", "\\x{20A0}-\\x{20CF}"},
+            {"CombiningMarksforSymbols", "\\x{20D0}-\\x{20FF}"},
+            {"LetterlikeSymbols", "\\x{2100}-\\x{214F}"},
+            {"NumberForms", "\\x{2150}-\\x{218F}"},
+            {"Arrows", "\\x{2190}-\\x{21FF}"},
+            {"MathematicalOperators", "\\x{2200}-\\x{22FF}"},
+            {"MiscellaneousTechnical", "\\x{2300}-\\x{23FF}"},
+            {"ControlPictures", "\\x{2400}-\\x{243F}"},
+            {"OpticalCharacterRecognition", "\\x{2440}-\\x{245F}"},
+            {"EnclosedAlphanumerics", "\\x{2460}-\\x{24FF}"},
+            {"BoxDrawing", "\\x{2500}-\\x{257F}"},
+            {"BlockElements", "\\x{2580}-\\x{259F}"},
+            {"GeometricShapes", "\\x{25A0}-\\x{25FF}"},
+            {"MiscellaneousSymbols", "\\x{2600}-\\x{26FF}"},
+            {"Dingbats", "\\x{2700}-\\x{27BF}"},
+            {"BraillePatterns", "\\x{2800}-\\x{28FF}"},
+            {"CJKRadicalsSupplement", "\\x{2E80}-\\x{2EFF}"},
+            {"KangxiRadicals", "\\x{2F00}-\\x{2FDF}"},
+            {"IdeographicDescriptionCharacters", "\\x{2FF0}-\\x{2FFF}"},
+            {"CJKSymbolsandPunctuation", "\\x{3000}-\\x{303F}"},
+            {"Hiragana", "\\x{3040}-\\x{309F}"},
+            {"Katakana", "\\x{30A0}-\\x{30FF}"},
+            {"Bopomofo", "\\x{3100}-\\x{312F}"},
+            {"HangulCompatibilityJamo", "\\x{3130}-\\x{318F}"},
+            {"Kanbun", "\\x{3190}-\\x{319F}"},
+            {"BopomofoExtended", "\\x{31A0}-\\x{31BF}"},
+            {"EnclosedCJKLettersandMonths", "\\x{3200}-\\x{32FF}"},
+            {"CJKCompatibility", "\\x{3300}-\\x{33FF}"},
+            {"CJKUnifiedIdeographsExtensionA", "\\x{3400}-\\x{4DB5}"},
+            {"CJKUnifiedIdeographs", "\\x{4E00}-\\x{9FFF}"},
+            {"YiSyllables", "\\x{A000}-\\x{A48F}"},
+            {"YiRadicals", "\\x{A490}-\\x{A4CF}"},
+            {"HangulSyllables", "\\x{AC00}-\\x{D7A3}"},
+            {"PrivateUse", "\\x{E000}-\\x{F8FF}"},
+            {"CJKCompatibilityIdeographs", "\\x{F900}-\\x{FAFF}"},
+            {"AlphabeticPresentationForms", "\\x{FB00}-\\x{FB4F}"},
+            {"ArabicPresentationForms-A", "\\x{FB50}-\\x{FDFF}"},
+            {"CombiningHalfMarks", "\\x{FE20}-\\x{FE2F}"},
+            {"CJKCompatibilityForms", "\\x{FE30}-\\x{FE4F}"},
+            {"SmallFormVariants", "\\x{FE50}-\\x{FE6F}"},
+            {"ArabicPresentationForms-B", "\\x{FE70}-\\x{FEFE}"},
+            {"HalfwidthandFullwidthForms", "\\x{FF00}-\\x{FFEF}"},
+        };
+
+        // replaces the block escape at pos, \p{IsBlock} or \P{IsBlock}, with its range, as
+        // libyang does before compiling the pattern. Returns false if it is not a known block.
+        static bool append_block(const std::string& pattern, size_t& pos, bool in_class, std::string& pcre_pattern)
+        {
+            if(pattern.compare(pos, 5, "\\p{Is") != 0 && pattern.compare(pos, 5, "\\P{Is") != 0) {
+                return false;
+            }
+            size_t end = pattern.find('}', pos);
+            if(end == std::string::npos) {
+                return false;
+            }
+            auto block = UNICODE_BLOCKS.find(pattern.substr(pos + 5, end - pos - 5));
+            bool negated = pattern[pos + 1] == 'P';
+            if(block == UNICODE_BLOCKS.end() || (negated && in_class)) {
+                return false;
+            }
+
+            if(in_class) {
+                pcre_pattern += block->second;
+            } else {
+                pcre_pattern += negated ? "[^" : "[";
+                pcre_pattern += block->second;
+                pcre_pattern += ']';
+            }
+            pos = end;
+            return true;
+        }
+
+        // XSD regular expressions match the whole value and have no anchors, ^ and $ are
+        // plain characters outside of character classes
+        static std::string get_pcre_pattern(const std::string& pattern)
+        {
+            std::string pcre_pattern{"^(?:"};
+            int class_depth = 0;
+            for(size_t i = 0; i < pattern.size(); ++i) {
+                char c = pattern[i];
+                if(c == '\\' && append_block(pattern, i, class_depth > 0, pcre_pattern)) {
+                    continue;
+                }
+                if(c == '\\' && i + 1 < pattern.size()) {
+                    pcre_pattern += c;
+                    pcre_pattern += pattern[++i];
+                    continue;
+                }
+
+                if(c == '[') {
+                    ++class_depth;
+                } else if(c == ']' && class_depth > 0) {
+                    --class_depth;
+                } else if((c == '^' || c == '$') && class_depth == 0) {
+                    pcre_pattern += '\\';
+                }
+                pcre_pattern += c;
+            }
+            pcre_pattern += ")$";
+            return pcre_pattern;
+        }
+
+        ///
+        /// A pattern restriction compiled with PCRE, the engine libyang validates patterns with
+        ///
+        class SchemaValueStringType::Pattern
+        {
+        public:
+            Pattern(const std::string& expression);
+            ~Pattern();
+
+            Pattern(const Pattern&) = delete;
+            Pattern& operator=(const Pattern&) = delete;
+
+            /// patterns which could not be compiled accept every value. They are translated as
+            /// libyang translates them, which rejects modules with patterns it cannot compile,
+            /// so this is not expected to happen
+            bool matches(const std::string& value) const;
+
+            std::string expression;
+
+        private:
+            pcre* code;
+            pcre_extra* extra;
+            bool invert;
+        };
+    }
+}
+
+ydk::path::SchemaValueStringType::Pattern::Pattern(const std::string& expression)
+    : expression{expression}, code{nullptr}, extra{nullptr}, invert{false}
+{
+    std::string regex{expression};
+    // libyang may mark the patterns as match (0x06) or invert-match (0x15) with their first byte
+    if(!regex.empty() && (regex[0] == 0x06 || regex[0] == 0x15)) {
+        invert = regex[0] == 0x15;
+        regex.erase(0, 1);
+        this->expression = regex;
+    }
+
+    const char* error = nullptr;
+    int error_offset = 0;
+    code = pcre_compile(get_pcre_pattern(regex).c_str(), PCRE_UTF8 | PCRE_DOLLAR_ENDONLY, &error, &error_offset, nullptr);
+    if(!code) {
+        BOOST_LOG_TRIVIAL(error) << "Could not compile pattern " << regex << " at offset " << error_offset
+                                 << ": " << error << ". Values will not be checked against it";
+        return;
+    }
+
+#ifdef PCRE_STUDY_JIT_COMPILE
+    extra = pcre_study(code, PCRE_STUDY_JIT_COMPILE, &error);
+#else
+    extra = pcre_study(code, 0, &error);
+#endif
+}
+
+ydk::path::SchemaValueStringType::Pattern::~Pattern()
+{
+    if(extra) {
+#ifdef PCRE_STUDY_JIT_COMPILE
+        pcre_free_study(extra);
+#else
+        pcre_free(extra);
+#endif
+    }
+    if(code) {
+        pcre_free(code);
+    }
+}
+
+bool
+ydk::path::SchemaValueStringType::Pattern::matches(const std::string& value) const
+{
+    if(!code) {
+        return true;
+    }
+
+    int rc = pcre_exec(code, extra, value.c_str(), static_cast<int>(value.size()), 0, 0, nullptr, 0);
+    if(rc >= 0) {
+        return !invert;
+    } else if(rc == PCRE_ERROR_NOMATCH) {
+        return invert;
+    }
+
+    BOOST_LOG_TRIVIAL(error) << "Matching " << value << " against pattern " << expression << " failed with " << rc;
+    return false;
+}
+
 ////////////////////////////////////////////////////////////////////
 // ydk::path::SchemaValueStringType
 ////////////////////////////////////////////////////////////////////////
@@ -307,10 +546,15 @@ ydk::path::SchemaValueStringType::validate(const std::string& value) const
 
     /// then a pattern check
     /// all patterns have to be matched
-    for(auto p : patterns) {
-        std::regex r {p};
-        if(!std::regex_match(p, r)){
-           BOOST_LOG_TRIVIAL(error) << "String " << value << " failed pattern " << p << " match";
+    std::call_once(patterns_compiled, [this]() {
+        for(auto const& p : patterns) {
+            compiled_patterns.push_back(std::make_unique<Pattern>(p));
+        }
+    });
+
+    for(auto const& p : compiled_patterns) {
+        if(!p->matches(value)){
+           BOOST_LOG_TRIVIAL(error) << "String " << value << " failed pattern " << p->expression << " match";
             diag.errors.push_back(ValidationError::INVALID_PATTERN);
         }
     }
@@ -28,12 +28,18 @@
 #ifndef YDK_CORE_HPP
 #define YDK_CORE_HPP
 
+#include <chrono>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <utility>
 #include <vector>
 #include <algorithm>
 #include "errors.hpp"
 #include <boost/filesystem.hpp>
 
+struct lyd_node;
+
 namespace ydk {
     namespace path {
 
@@ -233,6 +239,7 @@ namespace ydk {
 
         // Forward References
         class DataNode ;
+        class ModuleStore;
         class Rpc;
         class SchemaNode ;
         class RootSchemaNode ;
@@ -316,7 +323,69 @@ namespace ydk {
             ///
             virtual DataNode* decode(const RootSchemaNode* root_schema, const std::string& buffer, Format format);
 
+            ///
+            /// @brief decode a null terminated buffer in place, without copying it
+            ///
+            /// @param[in] root_schema The root schema to use.
+            /// @param[in] buffer The null terminated representation of the DataNode.
+            /// @param[in] format .Note ::TREE is not supported.
+            /// @return The DataNode instantiated or nullptr in case of error.
+            /// @throws YCPPInvalidArgumentError if the arguments are invalid.
+            ///
+            virtual DataNode* decode(const RootSchemaNode* root_schema, const char* buffer, Format format);
+
+            ///
+            /// @brief decode the content of a notification
+            ///
+            /// @param[in] root_schema The root schema to use.
+            /// @param[in] buffer The null terminated notification element, without its eventTime.
+            /// @param[in] format .Note ::TREE is not supported.
+            /// @return The DataNode instantiated.
+            /// @throws YCPPCodecError if the notification could not be parsed.
+            ///
+            virtual DataNode* decode_notification(const RootSchemaNode* root_schema, const char* buffer, Format format);
+
+
+        };
+
+        ///
+        /// @brief StreamingDecoder
+        ///
+        /// Decodes a payload that arrives as several documents, each holding some of the
+        /// top level subtrees. Every document is parsed as soon as it is added and merged
+        /// into the tree decoded so far, so the payload is never held in a single buffer.
+        ///
+        class StreamingDecoder
+        {
+        public:
+            StreamingDecoder(const RootSchemaNode* root_schema, CodecService::Format format);
+            ~StreamingDecoder();
+
+            StreamingDecoder(const StreamingDecoder&) = delete;
+            StreamingDecoder& operator=(const StreamingDecoder&) = delete;
+
+            ///
+            /// @brief parse the given null terminated document and merge it into the tree
+            ///
+            /// Top level containers already present in the tree are merged with the new ones,
+            /// other top level nodes are appended.
+            ///
+            /// @param[in] buffer The null terminated document.
+            /// @throws YCPPCodecError if the document could not be parsed.
+            ///
+            void add(const char* buffer);
+
+            ///
+            /// @brief hand over the merged tree
+            ///
+            /// @return The DataNode tree or nullptr if none of the documents held data.
+            ///
+            DataNode* finish();
 
+        private:
+            const RootSchemaNode* m_root_schema;
+            CodecService::Format m_format;
+            struct lyd_node* m_tree;
         };
 
 
@@ -840,8 +909,8 @@ namespace ydk {
             std::string module_name;
 
 
-            /// derived identities
-            std::vector<std::unique_ptr<SchemaValueIdentityType>> derived;
+            /// derived identities, the identities are shared by the schema they belong to
+            std::vector<SchemaValueIdentityType*> derived;
 
         };
 
@@ -912,7 +981,8 @@ namespace ydk {
         };
 
         ///
-        /// string types
+        /// string types. They keep their compiled patterns, which makes them neither copyable
+        /// nor movable.
         ///
         struct SchemaValueStringType : public SchemaValueType {
 
@@ -925,8 +995,15 @@ namespace ydk {
             /// length restriction
             LengthRangeIntervals<uint64_t> length;
 
-            /// pattern restrictions
+            /// pattern restrictions, in the XML Schema regular expression syntax. They are
+            /// compiled on the first validate, later changes are not picked up
             std::vector<std::string> patterns;
+
+        private:
+            class Pattern;
+
+            mutable std::once_flag patterns_compiled;
+            mutable std::vector<std::unique_ptr<Pattern>> compiled_patterns;
         };
 
         ///
@@ -938,8 +1015,8 @@ namespace ydk {
 
             DiagnosticNode<std::string, ValidationError> validate(const std::string& value) const;
 
-            /// types defined
-            std::vector<std::unique_ptr<SchemaValueType>> types;
+            /// types defined, owned by the schema they belong to
+            std::vector<SchemaValueType*> types;
         };
 
         ///
@@ -1050,8 +1127,10 @@ namespace ydk {
             /// Note this method will only work for SchemaNodes that represent a leaf
             /// or  leaf-list. Otherwise a nullptr will be returned.
             ///
+            /// The leaves of the same typedef share one SchemaValueType.
+            ///
             /// @return ptr to SchemaValueType or nullptr. User should not free this pointer
-            /// it is contained within the SchemaNode so destroying the SchemaNode.
+            /// it is contained within the RootSchemaNode so destroying the RootSchemaNode.
             ///
             virtual SchemaValueType & type() const = 0;
 
@@ -1337,6 +1416,26 @@ namespace ydk {
             ///
             virtual std::vector<Annotation> annotations() = 0;
 
+            ///
+            /// @brief appends the XPath expression of this Node, as returned by path(), to buffer
+            ///
+            /// Lets callers reuse a buffer, so that getting paths does not allocate
+            /// once the buffer is large enough. The default implementation appends path().
+            /// @param[out] buffer The string the path is appended to.
+            ///
+            virtual void append_path(std::string& buffer) const;
+
+            ///
+            /// @brief appends the last segment of the XPath expression of this Node to buffer
+            ///
+            /// The segment is qualified with the module name if the parent of the node is
+            /// in another module and carries the keys of a list entry, e.g.
+            /// neighbor[neighbor-address='172.16.255.2']. The default implementation appends
+            /// the last segment of path().
+            /// @param[out] buffer The string the segment is appended to.
+            ///
+            virtual void append_segment(std::string& buffer) const;
+
         };
 
         ///
@@ -1403,6 +1502,25 @@ namespace ydk {
             virtual std::string get_model(const std::string& name, const std::string& version, Format format) = 0;
             virtual std::string get_hostname_port()=0;
 
+            ///
+            /// @brief returns the models identified by the (name, version) pairs
+            ///
+            /// Used to download the models missing from the repository before they are parsed.
+            /// Providers which can have several requests in flight at once should override this,
+            /// by default get_model is called for each model in turn.
+            ///
+            /// @param[in] models the names and versions of the models
+            /// @param[in] format Format of the models to download
+            /// @return the data of each model, in the order of models. Empty for the models which cannot be provided
+            ///
+            virtual std::vector<std::string> get_models(const std::vector<std::pair<std::string, std::string>>& models, Format format)
+            {
+                std::vector<std::string> data;
+                for(auto & model : models)
+                    data.push_back(get_model(model.first, model.second, format));
+                return data;
+            }
+
 
         };
 
@@ -1446,6 +1564,20 @@ namespace ydk {
             ///
             RootSchemaNode* create_root_schema(const std::vector<path::Capability> & capabilities) ;
 
+            ///
+            /// @brief Returns the root schema for the capabilities shared across the process.
+            ///
+            /// Root schemas are interned by the search path and a fingerprint of the capabilities
+            /// and of the deviation modules found there: as long as a schema created for the same
+            /// ones is alive, by this repository or any other, it is returned instead of a new one.
+            /// The schema is freed along with its last owner. Shared root schemas can be used from
+            /// several threads at once, they do not download modules missing later on.
+            ///
+            /// @param[in] capabilities vector of Capability
+            /// @return the shared RootSchemaNode or nullptr if one could not be created.
+            ///
+            std::shared_ptr<RootSchemaNode> get_shared_root_schema(const std::vector<path::Capability> & capabilities);
+
             ///
             /// @brief Adds a model provider.
             ///
@@ -1474,11 +1606,57 @@ namespace ydk {
             ///
             std::vector<ModelProvider*> get_model_providers() const;
 
+            ///
+            /// @brief Defers loading the modules of the root schemas created to their first use.
+            ///
+            /// A lazily loaded root schema starts out without the modules of the capabilities.
+            /// A module is loaded, downloaded through the model providers if need be, the first
+            /// time a path naming it is used to find a schema node, create a data node or an
+            /// rpc. The modules deviating it are loaded along with it, as are the modules
+            /// augmenting it whose files are in the search directory.
+            ///
+            /// Decoding data loads the modules of its namespaces. Lazily loaded root schemas
+            /// are not cached nor shared and they need the repository to stay alive.
+            /// Loading a module waits for the threads finding schema nodes or building,
+            /// decoding, encoding or validating data against the schema, and holds them off
+            /// until it is done; a thread doing so cannot load a module meanwhile. Nodes
+            /// already found, children already listed and data already built stay valid.
+            ///
+            /// @param[in] lazy true to load modules on first use
+            ///
+            void set_lazy_loading(bool lazy);
+
+            ///
+            /// @brief Keeps the models downloaded through the model providers in a store shared
+            /// across repositories and processes.
+            ///
+            /// The store is content-addressed: each distinct model file is kept once, named
+            /// after its checksum, and indexed by model name and revision. A model found in
+            /// the store is hard linked into the search directory instead of being downloaded
+            /// again. Several processes can add to the same store at once. Models without a
+            /// revision are not stored. No store is used unless one is set.
+            ///
+            /// The checksums tell damaged files apart, not forged ones: the store has to be
+            /// writable by trusted users only.
+            ///
+            /// @param[in] store_dir The directory of the store, created if needed.
+            /// @throws YCPPInvalidArgumentError if the directory cannot be created or is
+            /// writable by others.
+            ///
+            void set_module_store(const std::string& store_dir);
+
+            ///
+            /// @brief The module store set with set_module_store, nullptr if there is none.
+            ///
+            ModuleStore* get_module_store() const;
+
 
             boost::filesystem::path path;
          private:
+            std::shared_ptr<ModuleStore> module_store;
             std::vector<ModelProvider*> model_providers;
             bool using_temp_directory;
+            bool lazy_loading = false;
         };
 
 
@@ -1511,6 +1689,28 @@ namespace ydk {
             ///
             virtual DataNode* invoke(Rpc* rpc) const = 0 ;
 
+            ///
+            /// @brief whether the provider uses the data trees attached to an input element
+            ///
+            /// The services attach the data trees for the element with Rpc::attach instead of
+            /// encoding them into its anyxml when the provider uses them. False by default.
+            ///
+            /// @param[in] name The name of the anyxml element of the rpc input, e.g. "entity"
+            /// @return true if trees attached to the element are used in place of its value
+            ///
+            virtual bool supports_attached_data(const std::string& name) const;
+
+            ///
+            /// @brief record the time taken to populate the entities of a read
+            ///
+            /// Called by the services once they have populated the entities read through
+            /// this provider. Does nothing unless the provider keeps stats of its rpcs.
+            ///
+            /// @param[in] config true for a read of the configuration only
+            /// @param[in] elapsed the time taken to populate the entities
+            ///
+            virtual void record_read_populate(bool config, std::chrono::steady_clock::duration elapsed) const;
+
         };
 
         ///
@@ -1551,6 +1751,27 @@ namespace ydk {
             /// @return pointer to the SchemaNode associated with this rpc.
             virtual SchemaNode* schema() const = 0;
 
+            ///
+            /// @brief attach a data tree to an anyxml element of the input by reference
+            ///
+            /// A provider which finds trees attached to an element uses them in place
+            /// of the element's value, so the data does not have to be encoded into the
+            /// anyxml and decoded again. The tree must outlive the invocation of the rpc.
+            ///
+            /// @param[in] name The name of the anyxml element, e.g. "entity"
+            /// @param[in] data The data tree to attach
+            /// @throws YCPPOperationNotSupportedError by default, for rpcs which cannot attach trees
+            ///
+            virtual void attach(const std::string& name, DataNode& data);
+
+            ///
+            /// @brief the data trees attached to an anyxml element of the input
+            ///
+            /// @param[in] name The name of the anyxml element
+            /// @return the attached trees in the order they were attached, none by default
+            ///
+            virtual std::vector<DataNode*> attached(const std::string& name) const;
+
 
         };
 
@@ -0,0 +1,195 @@
+/// YANG Development Kit
+// Copyright 2016 Cisco Systems. All rights reserved
+//
+////////////////////////////////////////////////////////////////
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+//
+//////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include <cstdio>
+#include <sstream>
+
+#include "startup_profile.hpp"
+
+using namespace std;
+
+static string escape_json(const string & text);
+
+namespace ydk
+{
+static thread_local StartupProfile * current_profile = nullptr;
+
+StartupProfile::Scope::Scope(StartupProfile & profile)
+	: previous(current_profile), active(true)
+{
+	current_profile = &profile;
+}
+
+StartupProfile::Scope::~Scope()
+{
+	end();
+}
+
+void StartupProfile::Scope::end()
+{
+	if(active)
+	{
+		current_profile = previous;
+		active = false;
+	}
+}
+
+StartupProfile::StartupProfile()
+	: origin(chrono::steady_clock::now())
+{
+}
+
+void StartupProfile::record(const string & name, const string & detail,
+		chrono::steady_clock::time_point start, chrono::steady_clock::duration elapsed)
+{
+	StartupPhase phase{};
+	phase.name = name;
+	phase.detail = detail;
+	phase.start = chrono::duration_cast<chrono::microseconds>(start - origin);
+	phase.elapsed = chrono::duration_cast<chrono::microseconds>(elapsed);
+
+	lock_guard<mutex> lock{profile_mutex};
+	phases.push_back(phase);
+}
+
+vector<StartupPhase> StartupProfile::get_phases() const
+{
+	lock_guard<mutex> lock{profile_mutex};
+	return phases;
+}
+
+map<string, chrono::microseconds> StartupProfile::get_totals() const
+{
+	map<string, vector<pair<chrono::microseconds, chrono::microseconds>>> intervals{};
+	for(auto & phase : get_phases())
+	{
+		intervals[phase.name].emplace_back(phase.start, phase.start + phase.elapsed);
+	}
+
+	map<string, chrono::microseconds> totals{};
+	for(auto & entry : intervals)
+	{
+		auto & spans = entry.second;
+		sort(spans.begin(), spans.end());
+		chrono::microseconds total{0};
+		auto current = spans.front();
+		for(auto & span : spans)
+		{
+			if(span.first > current.second)
+			{
+				total += current.second - current.first;
+				current = span;
+			}
+			else
+			{
+				current.second = max(current.second, span.second);
+			}
+		}
+		totals[entry.first] = total + current.second - current.first;
+	}
+	return totals;
+}
+
+chrono::microseconds StartupProfile::get_elapsed() const
+{
+	chrono::microseconds elapsed{0};
+	for(auto & phase : get_phases())
+	{
+		elapsed = max(elapsed, phase.start + phase.elapsed);
+	}
+	return elapsed;
+}
+
+string StartupProfile::to_json() const
+{
+	ostringstream json{};
+	json << "{\"elapsed_us\":" << get_elapsed().count() << ",\"totals\":{";
+	bool first = true;
+	for(auto & total : get_totals())
+	{
+		json << (first ? "" : ",") << "\"" << escape_json(total.first) << "\":" << total.second.count();
+		first = false;
+	}
+	json << "},\"phases\":[";
+	first = true;
+	for(auto & phase : get_phases())
+	{
+		json << (first ? "" : ",")
+		     << "{\"name\":\"" << escape_json(phase.name)
+		     << "\",\"detail\":\"" << escape_json(phase.detail)
+		     << "\",\"start_us\":" << phase.start.count()
+		     << ",\"elapsed_us\":" << phase.elapsed.count() << "}";
+		first = false;
+	}
+	json << "]}";
+	return json.str();
+}
+
+StartupProfile * StartupProfile::current()
+{
+	return current_profile;
+}
+
+StartupPhaseTimer::StartupPhaseTimer(const char* name, const string & detail)
+	: profile(StartupProfile::current()), name(name)
+{
+	if(profile != nullptr)
+	{
+		this->detail = detail;
+		start = chrono::steady_clock::now();
+	}
+}
+
+StartupPhaseTimer::~StartupPhaseTimer()
+{
+	if(profile != nullptr)
+	{
+		profile->record(name, detail, start, chrono::steady_clock::now() - start);
+	}
+}
+}
+
+static string escape_json(const string & text)
+{
+	string escaped{};
+	for(char c : text)
+	{
+		if(c == '"' || c == '\\')
+		{
+			escaped += '\\';
+			escaped += c;
+		}
+		else if(static_cast<unsigned char>(c) < 0x20)
+		{
+			char code[8];
+			snprintf(code, sizeof(code), "\\u%04x", c);
+			escaped += code;
+		}
+		else
+		{
+			escaped += c;
+		}
+	}
+	return escaped;
+}
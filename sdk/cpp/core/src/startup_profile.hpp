@@ -0,0 +1,109 @@
+/*  ----------------------------------------------------------------
+ Copyright 2016 Cisco Systems
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+------------------------------------------------------------------*/
+
+#ifndef _STARTUP_PROFILE_H_
+#define _STARTUP_PROFILE_H_
+
+#include <chrono>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace ydk {
+
+// One timed step of bringing up a provider, such as loading one module
+struct StartupPhase
+{
+	// what was done, e.g. "load-module"
+	std::string name;
+	// what it was done to, e.g. the module, empty if nothing in particular
+	std::string detail;
+	// since the profile was started
+	std::chrono::microseconds start{0};
+	std::chrono::microseconds elapsed{0};
+};
+
+// Records how long the steps of constructing a provider take: connecting, exchanging
+// capabilities, downloading models, loading modules and building the schema tree. The
+// steps are timed by the code performing them into the profile a Scope makes current on
+// the thread, so the profile reaches the repository and the sessions without being passed
+// along. Phases may nest, e.g. a get-schema within the load-module which needed it.
+class StartupProfile
+{
+public:
+	// makes the profile current on the calling thread until end() or destruction
+	class Scope
+	{
+	public:
+		explicit Scope(StartupProfile & profile);
+		~Scope();
+
+		Scope(const Scope&) = delete;
+		Scope& operator=(const Scope&) = delete;
+
+		void end();
+
+	private:
+		StartupProfile * previous;
+		bool active;
+	};
+
+public:
+	StartupProfile();
+
+	void record(const std::string & name, const std::string & detail,
+			std::chrono::steady_clock::time_point start, std::chrono::steady_clock::duration elapsed);
+
+	// in the order they finished
+	std::vector<StartupPhase> get_phases() const;
+	// phase name -> time spent in it, nested phases of the same name are counted once
+	std::map<std::string, std::chrono::microseconds> get_totals() const;
+	// from the start of the profile to the end of the last phase
+	std::chrono::microseconds get_elapsed() const;
+	// the phases and totals as a JSON object, for tooling comparing startups
+	std::string to_json() const;
+
+	// the profile current on the calling thread, nullptr if none
+	static StartupProfile * current();
+
+private:
+	mutable std::mutex profile_mutex;
+	std::chrono::steady_clock::time_point origin;
+	std::vector<StartupPhase> phases;
+};
+
+// Times a step from construction until it goes out of scope into the current profile;
+// does nothing when no profile is current
+class StartupPhaseTimer
+{
+public:
+	StartupPhaseTimer(const char* name, const std::string & detail = "");
+	~StartupPhaseTimer();
+
+	StartupPhaseTimer(const StartupPhaseTimer&) = delete;
+	StartupPhaseTimer& operator=(const StartupPhaseTimer&) = delete;
+
+private:
+	StartupProfile * profile;
+	const char* name;
+	std::string detail;
+	std::chrono::steady_clock::time_point start;
+};
+
+}
+
+#endif /*_STARTUP_PROFILE_H_*/
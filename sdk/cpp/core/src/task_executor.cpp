@@ -0,0 +1,121 @@
+/// YANG Development Kit
+// Copyright 2016 Cisco Systems. All rights reserved
+//
+////////////////////////////////////////////////////////////////
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+//
+//////////////////////////////////////////////////////////////////
+
+#include <boost/log/trivial.hpp>
+
+#include "task_executor.hpp"
+
+using namespace std;
+
+namespace ydk
+{
+static atomic<size_t> default_executor_threads{ThreadPoolExecutor::DEFAULT_THREADS};
+
+TaskExecutor::~TaskExecutor()
+{
+}
+
+const size_t ThreadPoolExecutor::DEFAULT_THREADS;
+
+ThreadPoolExecutor::ThreadPoolExecutor(size_t num_threads)
+	: stopping(false)
+{
+	if(num_threads == 0)
+	{
+		num_threads = 1;
+	}
+	BOOST_LOG_TRIVIAL(debug) << "Starting executor with " << num_threads << " thread(s)";
+	for(size_t i = 0; i < num_threads; ++i)
+	{
+		workers.emplace_back(&ThreadPoolExecutor::run, this);
+	}
+}
+
+ThreadPoolExecutor::~ThreadPoolExecutor()
+{
+	{
+		lock_guard<mutex> lock{queue_mutex};
+		stopping = true;
+	}
+	queue_not_empty.notify_all();
+	for(auto & worker : workers)
+	{
+		worker.join();
+	}
+}
+
+void ThreadPoolExecutor::post(function<void()> task)
+{
+	{
+		lock_guard<mutex> lock{queue_mutex};
+		tasks.push_back(move(task));
+	}
+	queue_not_empty.notify_one();
+}
+
+size_t ThreadPoolExecutor::concurrency() const
+{
+	return workers.size();
+}
+
+void ThreadPoolExecutor::run()
+{
+	while(true)
+	{
+		function<void()> task;
+		{
+			unique_lock<mutex> lock{queue_mutex};
+			queue_not_empty.wait(lock, [this]() { return stopping || !tasks.empty(); });
+			if(tasks.empty())
+			{
+				return;
+			}
+			task = move(tasks.front());
+			tasks.pop_front();
+		}
+		try
+		{
+			task();
+		}
+		catch(const exception & e)
+		{
+			BOOST_LOG_TRIVIAL(error) << "Task posted to executor failed: " << e.what();
+		}
+		catch(...)
+		{
+			BOOST_LOG_TRIVIAL(error) << "Task posted to executor failed with an unknown exception";
+		}
+	}
+}
+
+TaskExecutor & get_default_executor()
+{
+	static ThreadPoolExecutor executor{default_executor_threads.load()};
+	return executor;
+}
+
+void set_default_executor_threads(size_t num_threads)
+{
+	default_executor_threads = num_threads;
+}
+}
@@ -0,0 +1,115 @@
+//
+// @file task_executor.hpp
+// @brief Executors used by the asynchronous service APIs.
+//
+// YANG Development Kit
+// Copyright 2016 Cisco Systems. All rights reserved
+//
+////////////////////////////////////////////////////////////////
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+//
+//////////////////////////////////////////////////////////////////
+
+
+#ifndef TASK_EXECUTOR_HPP
+#define TASK_EXECUTOR_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace ydk
+{
+
+// Runs tasks posted to it, on threads it owns or borrows.
+class TaskExecutor
+{
+	public:
+		virtual ~TaskExecutor();
+		virtual void post(std::function<void()> task) = 0;
+		// number of tasks run at the same time
+		virtual std::size_t concurrency() const = 0;
+};
+
+// Fixed number of worker threads serving a FIFO queue of tasks. The service operations block
+// on the network while they run, so the number of threads bounds the operations in flight;
+// NetconfReactor drives many sessions without a thread for each.
+// The destructor runs the tasks already queued before joining the workers.
+class ThreadPoolExecutor : public TaskExecutor
+{
+	public:
+		// suits tasks which mostly wait for replies, not for the CPU
+		static const std::size_t DEFAULT_THREADS = 16;
+
+		explicit ThreadPoolExecutor(std::size_t num_threads = DEFAULT_THREADS);
+		~ThreadPoolExecutor();
+
+		void post(std::function<void()> task);
+		std::size_t concurrency() const;
+
+	private:
+		void run();
+
+	private:
+		std::mutex queue_mutex;
+		std::condition_variable queue_not_empty;
+		std::deque<std::function<void()>> tasks;
+		bool stopping;
+		std::vector<std::thread> workers;
+};
+
+// Executor shared by services constructed without one, started on first use
+TaskExecutor & get_default_executor();
+
+// Number of threads of the default executor, ThreadPoolExecutor::DEFAULT_THREADS unless set.
+// Only takes effect if called before the default executor is first used.
+void set_default_executor_threads(std::size_t num_threads);
+
+template<typename Function>
+std::future<typename std::result_of<Function()>::type> submit(TaskExecutor & executor, Function function)
+{
+	using Result = typename std::result_of<Function()>::type;
+	auto task = std::make_shared<std::packaged_task<Result()>>(std::move(function));
+	auto future = task->get_future();
+	executor.post([task]() { (*task)(); });
+	return future;
+}
+
+// The callback is handed the ready future, from which it gets the result or the exception
+template<typename Function, typename Callback>
+void submit(TaskExecutor & executor, Function function, Callback callback)
+{
+	using Result = typename std::result_of<Function()>::type;
+	auto task = std::make_shared<std::packaged_task<Result()>>(std::move(function));
+	executor.post([task, callback]() {
+		auto future = task->get_future();
+		(*task)();
+		callback(std::move(future));
+	});
+}
+
+}
+
+#endif /* TASK_EXECUTOR_HPP */
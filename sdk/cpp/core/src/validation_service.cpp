@@ -21,6 +21,7 @@
 //
 //////////////////////////////////////////////////////////////////
 
+#include "path/path_private.hpp"
 #include "service.hpp"
 #include "validation_service.hpp"
 #include <map>
@@ -75,8 +76,9 @@ validate_attributes(const EntityPath& entity_path, const ydk::path::SchemaNode&
         else
         {
             ydk::path::SchemaNode* leaf_schema_node = leaf_schema_node_list[0];
-            //now test to see if the value is correct
+            //now test to see if the value is correct, the identities loading a module derives stay put meanwhile
             ydk::path::SchemaValueType & type = leaf_schema_node->type();
+            ydk::path::SchemaReadLock read_lock{leaf_schema_node};
 	    auto attr = type.validate(value_path.second.value);
 	    if(attr.has_errors())
             {
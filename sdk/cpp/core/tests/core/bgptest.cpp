@@ -23,8 +23,12 @@
 
 #define BOOST_TEST_MODULE OCBgpTest
 #include <boost/test/unit_test.hpp>
+#include <atomic>
+#include <fstream>
 #include <iostream>
+#include <thread>
 #include "../../src/path_api.hpp"
+#include "../../src/startup_profile.hpp"
 #include "../config.hpp"
 
 
@@ -63,6 +67,47 @@ private:
     std::vector<ydk::path::Capability> m_capabilities;
 
 };
+
+class MockModelProvider : public ydk::path::ModelProvider
+{
+public:
+    MockModelProvider(const std::string searchdir) : m_searchdir{searchdir}, get_models_calls{0}
+    {
+
+    }
+
+    std::string get_model(const std::string& name, const std::string& version, Format format)
+    {
+        return read_model(name, version);
+    }
+
+    std::vector<std::string> get_models(const std::vector<std::pair<std::string, std::string>>& models, Format format)
+    {
+        ++get_models_calls;
+        std::vector<std::string> data;
+        for(auto & model : models)
+            data.push_back(read_model(model.first, model.second));
+        return data;
+    }
+
+    std::string get_hostname_port()
+    {
+        return "mock";
+    }
+
+private:
+    std::string read_model(const std::string& name, const std::string& version)
+    {
+        std::ifstream file{m_searchdir + "/" + name + (version.empty() ? "" : "@" + version) + ".yang"};
+        return std::string{std::istreambuf_iterator<char>{file}, std::istreambuf_iterator<char>{}};
+    }
+
+private:
+    std::string m_searchdir;
+
+public:
+    int get_models_calls;
+};
 }
 
 
@@ -416,6 +461,544 @@ BOOST_AUTO_TEST_CASE( decode_remove_as )
 
 }
 
+BOOST_AUTO_TEST_CASE( streaming_decode_merge )
+{
+    std::string searchdir{TEST_HOME};
+    mock::MockServiceProvider sp{searchdir, test_openconfig};
+
+    std::unique_ptr<ydk::path::RootSchemaNode> schema{sp.get_root_schema()};
+
+    BOOST_REQUIRE(schema.get() != nullptr);
+
+    ydk::path::StreamingDecoder decoder{schema.get(), ydk::path::CodecService::Format::XML};
+    decoder.add("<bgp xmlns=\"http://openconfig.net/yang/bgp\"><global><config><as>65172</as></config></global></bgp>");
+    decoder.add("<bgp xmlns=\"http://openconfig.net/yang/bgp\"><neighbors><neighbor><neighbor-address>1.2.3.4</neighbor-address><config><neighbor-address>1.2.3.4</neighbor-address></config></neighbor></neighbors></bgp>");
+
+    auto bgp = decoder.finish();
+    BOOST_REQUIRE( bgp != nullptr);
+    BOOST_REQUIRE( bgp->children().size() == 1);
+
+    auto as = bgp->find("openconfig-bgp:bgp/global/config/as");
+    BOOST_REQUIRE( !as.empty());
+    BOOST_REQUIRE( as[0]->get() == "65172");
+
+    auto neighbor = bgp->find("openconfig-bgp:bgp/neighbors/neighbor[neighbor-address='1.2.3.4']");
+    BOOST_REQUIRE( !neighbor.empty());
+
+    BOOST_REQUIRE( decoder.finish() == nullptr);
+}
+
+BOOST_AUTO_TEST_CASE( rpc_attached_data )
+{
+    std::string searchdir{TEST_HOME};
+    mock::MockServiceProvider sp{searchdir, test_openconfig};
+
+    std::unique_ptr<ydk::path::RootSchemaNode> schema{sp.get_root_schema()};
+
+    BOOST_REQUIRE(schema.get() != nullptr);
+
+    auto bgp = schema->create("openconfig-bgp:bgp", "");
+    BOOST_REQUIRE( bgp != nullptr );
+
+    std::unique_ptr<ydk::path::Rpc> create_rpc { schema->rpc("ydk:create") };
+    BOOST_REQUIRE( create_rpc->attached("entity").empty());
+
+    create_rpc->attach("entity", *bgp);
+    auto attached = create_rpc->attached("entity");
+    BOOST_REQUIRE( attached.size() == 1);
+    BOOST_REQUIRE( attached[0] == bgp);
+    BOOST_REQUIRE( create_rpc->attached("filter").empty());
+
+    //nothing is encoded into the anyxml
+    BOOST_REQUIRE( create_rpc->input()->find("entity").empty());
+}
+
+BOOST_AUTO_TEST_CASE( lazy_schema_nodes )
+{
+    std::string searchdir{TEST_HOME};
+    ydk::path::Repository repo{searchdir};
+    std::unique_ptr<ydk::path::RootSchemaNode> schema{repo.create_root_schema(test_openconfig)};
+    BOOST_REQUIRE(schema.get() != nullptr);
+
+    //a node deep in the tree is found before any of its ancestors' children were asked for
+    auto as = schema->find("openconfig-bgp:bgp/global/config/as");
+    BOOST_REQUIRE(as.size() == 1);
+    BOOST_REQUIRE(as[0]->statement().keyword == "leaf");
+    BOOST_REQUIRE(as[0]->parent()->statement().arg == "config");
+    BOOST_REQUIRE(as[0]->parent()->parent()->statement().arg == "global");
+    BOOST_REQUIRE(as[0]->type().type != ydk::path::SchemaValueType::DataType::UNKNOWN);
+
+    auto neighbor = schema->find("openconfig-bgp:bgp/neighbors/neighbor");
+    BOOST_REQUIRE(neighbor.size() == 1);
+    auto keys = neighbor[0]->keys();
+    BOOST_REQUIRE(keys.size() == 1);
+    BOOST_REQUIRE(keys[0].arg == "neighbor-address");
+
+    //the wrappers created on demand are those children() hands out
+    auto config = as[0]->parent();
+    bool found = false;
+    for(auto & child : config->children())
+    {
+        if(child.get() == as[0])
+            found = true;
+    }
+    BOOST_REQUIRE(found);
+
+    //and data nodes find their schema nodes in the same tree
+    auto bgp = schema->create("openconfig-bgp:bgp", "");
+    BOOST_REQUIRE( bgp != nullptr );
+    std::unique_ptr<const ydk::path::DataNode> data_root{bgp->root()};
+    auto as_data = bgp->create("global/config/as", "65172");
+    BOOST_REQUIRE(as_data->schema() == as[0]);
+}
+
+BOOST_AUTO_TEST_CASE( schema_path_index )
+{
+    std::string searchdir{TEST_HOME};
+    ydk::path::Repository repo{searchdir};
+    std::unique_ptr<ydk::path::RootSchemaNode> schema{repo.create_root_schema(test_openconfig)};
+    BOOST_REQUIRE(schema.get() != nullptr);
+
+    auto config = schema->find("openconfig-bgp:bgp/global/config");
+    BOOST_REQUIRE(config.size() == 1);
+    //looked up again from the index
+    BOOST_REQUIRE(schema->find("openconfig-bgp:bgp/global/config") == config);
+
+    auto bgp = schema->find("openconfig-bgp:bgp");
+    BOOST_REQUIRE(bgp.size() == 1);
+    BOOST_REQUIRE(bgp[0]->find("global/config") == config);
+    BOOST_REQUIRE(bgp[0]->find("global/config") == config);
+
+    //paths which are not found are not indexed
+    BOOST_REQUIRE(schema->find("openconfig-bgp:bgp/no-such-node").empty());
+    BOOST_REQUIRE(bgp[0]->find("no-such-node").empty());
+}
+
+BOOST_AUTO_TEST_CASE( node_paths )
+{
+    std::string searchdir{TEST_HOME};
+    ydk::path::Repository repo{searchdir};
+    std::unique_ptr<ydk::path::RootSchemaNode> schema{repo.create_root_schema(test_openconfig)};
+    BOOST_REQUIRE(schema.get() != nullptr);
+
+    auto config = schema->find("openconfig-bgp:bgp/global/config");
+    BOOST_REQUIRE(config.size() == 1);
+    BOOST_REQUIRE(config[0]->path() == "/openconfig-bgp:bgp/global/config");
+    //the path is worked out once, later calls give the same
+    BOOST_REQUIRE(config[0]->path() == "/openconfig-bgp:bgp/global/config");
+
+    auto bgp = schema->create("openconfig-bgp:bgp", "");
+    BOOST_REQUIRE( bgp != nullptr );
+    std::unique_ptr<const ydk::path::DataNode> data_root{bgp->root()};
+
+    auto neighbor = bgp->create("neighbors/neighbor[neighbor-address='172.16.255.2']", "");
+    BOOST_REQUIRE( neighbor != nullptr );
+    BOOST_REQUIRE(neighbor->path() == "/openconfig-bgp:bgp/neighbors/neighbor[neighbor-address='172.16.255.2']");
+
+    std::string buffer{};
+    neighbor->append_path(buffer);
+    BOOST_REQUIRE(buffer == neighbor->path());
+
+    buffer.clear();
+    neighbor->append_segment(buffer);
+    BOOST_REQUIRE(buffer == "neighbor[neighbor-address='172.16.255.2']");
+
+    buffer.clear();
+    bgp->append_segment(buffer);
+    BOOST_REQUIRE(buffer == "openconfig-bgp:bgp");
+
+    //the defaults for other DataNode implementations work from path()
+    buffer.clear();
+    neighbor->ydk::path::DataNode::append_segment(buffer);
+    BOOST_REQUIRE(buffer == "neighbor[neighbor-address='172.16.255.2']");
+
+    //leaf-list entries carry their value, quoted with whichever quote it does not hold
+    auto runner = schema->create("ydktest-sanity:runner", "");
+    BOOST_REQUIRE( runner != nullptr );
+    std::unique_ptr<const ydk::path::DataNode> runner_root{runner->root()};
+    auto plain = runner->create("ytypes/built-in-t/llunion", "10");
+    BOOST_REQUIRE( plain != nullptr );
+    BOOST_REQUIRE(plain->path() == "/ydktest-sanity:runner/ytypes/built-in-t/llunion[.='10']");
+    auto quoted = runner->create("ytypes/built-in-t/llstring", "it's");
+    BOOST_REQUIRE( quoted != nullptr );
+    BOOST_REQUIRE(quoted->path() == "/ydktest-sanity:runner/ytypes/built-in-t/llstring[.=\"it's\"]");
+
+    buffer.clear();
+    plain->append_segment(buffer);
+    BOOST_REQUIRE(buffer == "llunion[.='10']");
+    buffer.clear();
+    quoted->append_segment(buffer);
+    BOOST_REQUIRE(buffer == "llstring[.=\"it's\"]");
+    buffer.clear();
+    quoted->ydk::path::DataNode::append_segment(buffer);
+    BOOST_REQUIRE(buffer == "llstring[.=\"it's\"]");
+}
+
+BOOST_AUTO_TEST_CASE( shared_value_types )
+{
+    std::string searchdir{TEST_HOME};
+    ydk::path::Repository repo{searchdir};
+    std::unique_ptr<ydk::path::RootSchemaNode> schema{repo.create_root_schema(test_openconfig)};
+    BOOST_REQUIRE(schema.get() != nullptr);
+
+    //leaves of the same typedef share their type
+    auto as = schema->find("openconfig-bgp:bgp/global/config/as");
+    auto peer_as = schema->find("openconfig-bgp:bgp/neighbors/neighbor/config/peer-as");
+    BOOST_REQUIRE(as.size() == 1 && peer_as.size() == 1);
+    BOOST_REQUIRE(&as[0]->type() == &peer_as[0]->type());
+
+    //identityrefs of the same base share the identity, leafrefs the type of their target
+    auto afi_safi_name = schema->find("openconfig-bgp:bgp/global/afi-safis/afi-safi/config/afi-safi-name");
+    auto peer_group_afi_safi_name = schema->find("openconfig-bgp:bgp/peer-groups/peer-group/afi-safis/afi-safi/config/afi-safi-name");
+    auto afi_safi_key = schema->find("openconfig-bgp:bgp/global/afi-safis/afi-safi/afi-safi-name");
+    BOOST_REQUIRE(afi_safi_name.size() == 1 && peer_group_afi_safi_name.size() == 1 && afi_safi_key.size() == 1);
+    BOOST_REQUIRE(&afi_safi_name[0]->type() == &peer_group_afi_safi_name[0]->type());
+    BOOST_REQUIRE(&afi_safi_name[0]->type() == &afi_safi_key[0]->type());
+
+    auto diag = afi_safi_key[0]->type().validate("openconfig-bgp-types:L3VPN_IPV4_UNICAST");
+    BOOST_REQUIRE(!diag.has_errors());
+}
+
+BOOST_AUTO_TEST_CASE( string_patterns )
+{
+    ydk::path::SchemaValueStringType string_type{};
+    string_type.patterns.push_back("[0-9]+(\\.[0-9]+)?");
+    string_type.patterns.push_back(".*[^a-z]");
+
+    //patterns match the whole value
+    BOOST_REQUIRE(!string_type.validate("12.5").has_errors());
+    BOOST_REQUIRE(string_type.validate("12.5a").has_errors());
+    BOOST_REQUIRE(string_type.validate("x12").has_errors());
+    BOOST_REQUIRE(!string_type.validate("7").has_errors());
+
+    //^ and $ are plain characters
+    ydk::path::SchemaValueStringType anchor_type{};
+    anchor_type.patterns.push_back("a^b$");
+    BOOST_REQUIRE(!anchor_type.validate("a^b$").has_errors());
+    BOOST_REQUIRE(anchor_type.validate("ab").has_errors());
+
+    //Unicode blocks are ranges, in and out of character classes
+    ydk::path::SchemaValueStringType block_type{};
+    block_type.patterns.push_back("\\p{IsBasicLatin}+[\\p{IsGreek}0-9]\\P{IsBasicLatin}");
+    BOOST_REQUIRE(!block_type.validate("ab\u03b1\u00e9").has_errors());
+    BOOST_REQUIRE(!block_type.validate("ab7\u00e9").has_errors());
+    BOOST_REQUIRE(block_type.validate("ab7e").has_errors());
+    BOOST_REQUIRE(block_type.validate("\u00e9b7\u00e9").has_errors());
+
+    std::string searchdir{TEST_HOME};
+    ydk::path::Repository repo{searchdir};
+    std::unique_ptr<ydk::path::RootSchemaNode> schema{repo.create_root_schema(test_openconfig)};
+    BOOST_REQUIRE(schema.get() != nullptr);
+
+    auto neighbor_address = schema->find("openconfig-bgp:bgp/neighbors/neighbor/config/neighbor-address");
+    BOOST_REQUIRE(neighbor_address.size() == 1);
+    BOOST_REQUIRE(!neighbor_address[0]->type().validate("172.16.255.2").has_errors());
+    BOOST_REQUIRE(neighbor_address[0]->type().validate("172.16.255.2/32").has_errors());
+}
+
+BOOST_AUTO_TEST_CASE( module_store )
+{
+    auto store_dir = boost::filesystem::temp_directory_path() / boost::filesystem::unique_path();
+    auto first_dir = boost::filesystem::temp_directory_path() / boost::filesystem::unique_path();
+    auto second_dir = boost::filesystem::temp_directory_path() / boost::filesystem::unique_path();
+    boost::filesystem::create_directories(first_dir);
+    boost::filesystem::create_directories(second_dir);
+
+    //only models with a revision are stored
+    std::vector<ydk::path::Capability> capabilities {
+        {"openconfig-bgp-types", "2016-06-21"},
+        {"openconfig-bgp", "2016-06-21"},
+        {"openconfig-extensions", "2015-10-09"},
+        {"openconfig-interfaces", "2016-05-26"},
+        {"openconfig-policy-types", "2016-05-12"},
+        {"openconfig-routing-policy", "2016-05-12"},
+        {"openconfig-types", "2016-05-31"},
+        {"ietf-interfaces", "2014-05-08"}
+    };
+
+    mock::MockModelProvider first_provider{TEST_HOME};
+    ydk::path::Repository first_repo{first_dir.string()};
+    first_repo.set_module_store(store_dir.string());
+    first_repo.add_model_provider(&first_provider);
+    std::unique_ptr<ydk::path::RootSchemaNode> first_schema{first_repo.create_root_schema(capabilities)};
+    BOOST_REQUIRE(first_schema.get() != nullptr);
+    BOOST_REQUIRE(first_provider.get_models_calls > 0);
+
+    //another device with the same models gets them from the store instead of downloading them
+    mock::MockModelProvider second_provider{TEST_HOME};
+    ydk::path::Repository second_repo{second_dir.string()};
+    second_repo.set_module_store(store_dir.string());
+    second_repo.add_model_provider(&second_provider);
+    std::unique_ptr<ydk::path::RootSchemaNode> second_schema{second_repo.create_root_schema(capabilities)};
+    BOOST_REQUIRE(second_schema.get() != nullptr);
+    BOOST_REQUIRE(!second_schema->find("openconfig-bgp:bgp").empty());
+    BOOST_REQUIRE(second_provider.get_models_calls == 0);
+    BOOST_REQUIRE(boost::filesystem::hard_link_count(second_dir / "openconfig-bgp@2016-06-21.yang") > 1);
+    BOOST_REQUIRE(second_repo.get_module_store() != nullptr);
+
+    //a store anyone can write to is refused, and none is used unless set
+    ydk::path::Repository third_repo{};
+    BOOST_REQUIRE(third_repo.get_module_store() == nullptr);
+    boost::filesystem::permissions(store_dir, boost::filesystem::add_perms | boost::filesystem::others_write);
+    BOOST_REQUIRE_THROW(third_repo.set_module_store(store_dir.string()), ydk::YCPPInvalidArgumentError);
+
+    first_repo.remove_model_provider(&first_provider);
+    second_repo.remove_model_provider(&second_provider);
+    boost::filesystem::remove_all(store_dir);
+    boost::filesystem::remove_all(first_dir);
+    boost::filesystem::remove_all(second_dir);
+}
+
+BOOST_AUTO_TEST_CASE( startup_profile )
+{
+    ydk::StartupProfile profile{};
+    {
+        ydk::StartupProfile::Scope scope{profile};
+        ydk::path::Repository repo{TEST_HOME};
+        std::unique_ptr<ydk::path::RootSchemaNode> schema{repo.create_root_schema(test_openconfig)};
+        BOOST_REQUIRE(schema.get() != nullptr);
+    }
+    BOOST_REQUIRE(ydk::StartupProfile::current() == nullptr);
+
+    bool bgp_loaded = false;
+    for(auto & phase : profile.get_phases())
+    {
+        if(phase.name == "load-module" && phase.detail == "openconfig-bgp")
+            bgp_loaded = true;
+        BOOST_REQUIRE(phase.start + phase.elapsed <= profile.get_elapsed());
+    }
+    BOOST_REQUIRE(bgp_loaded);
+
+    auto totals = profile.get_totals();
+    BOOST_REQUIRE(totals["load-module"] <= totals["create-root-schema"]);
+    BOOST_REQUIRE(totals["build-schema-tree"] <= totals["create-root-schema"]);
+    BOOST_REQUIRE(profile.to_json().find("\"detail\":\"openconfig-bgp\"") != std::string::npos);
+}
+
+BOOST_AUTO_TEST_CASE( prefetch_models )
+{
+    auto download_dir = boost::filesystem::temp_directory_path() / boost::filesystem::unique_path();
+    boost::filesystem::create_directories(download_dir);
+
+    std::vector<ydk::path::Capability> capabilities {
+        {"openconfig-bgp-types", ""},
+        {"openconfig-bgp", ""},
+        {"openconfig-extensions", ""},
+        {"openconfig-interfaces", ""},
+        {"openconfig-policy-types", ""},
+        {"openconfig-routing-policy", ""},
+        {"openconfig-types", ""},
+        {"ietf-interfaces", ""}
+    };
+    mock::MockModelProvider provider{TEST_HOME};
+    ydk::path::Repository repo{download_dir.string()};
+    repo.add_model_provider(&provider);
+    std::unique_ptr<ydk::path::RootSchemaNode> schema{repo.create_root_schema(capabilities)};
+    BOOST_REQUIRE(schema.get() != nullptr);
+    BOOST_REQUIRE(!schema->find("openconfig-bgp:bgp").empty());
+
+    //the modules, then the submodules they include, were downloaded in batches before parsing
+    BOOST_REQUIRE(provider.get_models_calls >= 2);
+    BOOST_REQUIRE(boost::filesystem::is_regular_file(download_dir / "openconfig-bgp.yang"));
+
+    repo.remove_model_provider(&provider);
+    boost::filesystem::remove_all(download_dir);
+}
+
+BOOST_AUTO_TEST_CASE( shared_root_schema )
+{
+    std::string searchdir{TEST_HOME};
+    ydk::path::Repository repo{searchdir};
+    ydk::path::Repository other_repo{searchdir};
+
+    auto schema = repo.get_shared_root_schema(test_openconfig);
+    BOOST_REQUIRE(schema != nullptr);
+
+    //interned across repositories, whatever the order of the capabilities
+    auto reversed = test_openconfig;
+    std::reverse(reversed.begin(), reversed.end());
+    BOOST_REQUIRE(other_repo.get_shared_root_schema(reversed) == schema);
+
+    std::vector<ydk::path::Capability> other_capabilities{test_openconfig.begin(), test_openconfig.end() - 1};
+    auto other = repo.get_shared_root_schema(other_capabilities);
+    BOOST_REQUIRE(other != nullptr);
+    BOOST_REQUIRE(other != schema);
+
+    //a repository without a search directory looks models up in the directory of its device
+    mock::MockModelProvider provider{searchdir};
+    ydk::path::Repository temp_repo{};
+    temp_repo.add_model_provider(&provider);
+    BOOST_REQUIRE(temp_repo.path == boost::filesystem::temp_directory_path() / provider.get_hostname_port());
+    temp_repo.remove_model_provider(&provider);
+
+    //freed with its last owner
+    std::weak_ptr<ydk::path::RootSchemaNode> weak = schema;
+    schema.reset();
+    BOOST_REQUIRE(weak.expired());
+}
+
+BOOST_AUTO_TEST_CASE( lazy_loading )
+{
+    std::string searchdir{TEST_HOME};
+    ydk::path::Repository repo{searchdir};
+    repo.set_lazy_loading(true);
+
+    std::unique_ptr<ydk::path::RootSchemaNode> schema{repo.create_root_schema(test_openconfig)};
+    BOOST_REQUIRE(schema.get() != nullptr);
+    auto is_loaded = [&schema](const std::string & module) {
+        for(auto & child : schema->children())
+        {
+            if(child->path().find(module + ":") != std::string::npos)
+                return true;
+        }
+        return false;
+    };
+    BOOST_REQUIRE(!is_loaded("openconfig-bgp"));
+
+    auto as = schema->create("openconfig-bgp:bgp/global/config/as", "65172");
+    BOOST_REQUIRE( as != nullptr );
+    BOOST_REQUIRE(is_loaded("openconfig-bgp"));
+    BOOST_REQUIRE(!schema->find("openconfig-bgp:bgp/neighbors").empty());
+    BOOST_REQUIRE(!is_loaded("ietf-interfaces"));
+
+    std::unique_ptr<ydk::path::Rpc> create_rpc { schema->rpc("ydk:create") };
+    BOOST_REQUIRE( create_rpc != nullptr );
+}
+
+BOOST_AUTO_TEST_CASE( lazy_loading_threads )
+{
+    std::string searchdir{TEST_HOME};
+    ydk::path::Repository repo{searchdir};
+    repo.set_lazy_loading(true);
+
+    std::unique_ptr<ydk::path::RootSchemaNode> schema{repo.create_root_schema(test_openconfig)};
+    BOOST_REQUIRE(schema.get() != nullptr);
+    auto bgp = schema->create("openconfig-bgp:bgp/global/config/as", "65172");
+    BOOST_REQUIRE( bgp != nullptr );
+    std::unique_ptr<const ydk::path::DataNode> bgp_root{bgp->root()};
+
+    //modules are loaded while other threads decode and encode against the schema
+    ydk::path::CodecService s{};
+    std::atomic<int> failures{0};
+    std::vector<std::thread> readers;
+    for(int i = 0; i < 4; ++i)
+    {
+        readers.emplace_back([&schema, &s, &failures]() {
+            for(int j = 0; j < 20; ++j)
+            {
+                std::unique_ptr<ydk::path::DataNode> decoded{s.decode(schema.get(), m, ydk::path::CodecService::Format::XML)};
+                if(decoded == nullptr || s.encode(decoded.get(), ydk::path::CodecService::Format::XML, false).empty())
+                    ++failures;
+            }
+        });
+    }
+    auto interface = schema->create("ietf-interfaces:interfaces/interface[name='Loopback10']/description", "test");
+    BOOST_REQUIRE( interface != nullptr );
+    std::unique_ptr<const ydk::path::DataNode> interface_root{interface->root()};
+    BOOST_REQUIRE(!schema->find("openconfig-routing-policy:routing-policy").empty());
+    for(auto & reader : readers)
+        reader.join();
+    BOOST_REQUIRE(failures == 0);
+}
+
+BOOST_AUTO_TEST_CASE( lazy_loading_find_threads )
+{
+    std::string searchdir{TEST_HOME};
+    ydk::path::Repository repo{searchdir};
+    repo.set_lazy_loading(true);
+
+    std::unique_ptr<ydk::path::RootSchemaNode> schema{repo.create_root_schema(test_openconfig)};
+    BOOST_REQUIRE(schema.get() != nullptr);
+    auto bgp_schema = schema->find("openconfig-bgp:bgp");
+    BOOST_REQUIRE(!bgp_schema.empty());
+
+    //schema and data nodes are looked up and their children listed while modules are loaded
+    std::atomic<int> failures{0};
+    std::vector<std::thread> readers;
+    for(int i = 0; i < 4; ++i)
+    {
+        readers.emplace_back([&schema, &bgp_schema, &failures]() {
+            for(int j = 0; j < 20; ++j)
+            {
+                if(bgp_schema[0]->find("global/config/as").empty() || bgp_schema[0]->children().empty())
+                    ++failures;
+                auto as = schema->create("openconfig-bgp:bgp/global/config/as", "65172");
+                std::unique_ptr<const ydk::path::DataNode> as_root{as->root()};
+                auto bgp = as_root->children();
+                if(bgp.size() != 1 || bgp[0]->find("global/config/as").empty())
+                    ++failures;
+                bgp[0]->create("global/config/router-id", "1.2.3.4");
+                if(bgp[0]->children().empty())
+                    ++failures;
+            }
+        });
+    }
+    auto interface = schema->create("ietf-interfaces:interfaces/interface[name='Loopback10']/description", "test");
+    BOOST_REQUIRE( interface != nullptr );
+    std::unique_ptr<const ydk::path::DataNode> interface_root{interface->root()};
+    BOOST_REQUIRE(!schema->find("openconfig-routing-policy:routing-policy").empty());
+    for(auto & reader : readers)
+        reader.join();
+    BOOST_REQUIRE(failures == 0);
+}
+
+BOOST_AUTO_TEST_CASE( lazy_loading_decode )
+{
+    std::string searchdir{TEST_HOME};
+    ydk::path::Repository repo{searchdir};
+    repo.set_lazy_loading(true);
+
+    std::unique_ptr<ydk::path::RootSchemaNode> schema{repo.create_root_schema(test_openconfig)};
+    BOOST_REQUIRE(schema.get() != nullptr);
+
+    //the namespaces of the payload name the modules to load
+    ydk::path::CodecService s{};
+    std::unique_ptr<ydk::path::DataNode> decoded{s.decode(schema.get(), m, ydk::path::CodecService::Format::XML)};
+    BOOST_REQUIRE(decoded != nullptr);
+    BOOST_REQUIRE(!decoded->children().empty());
+
+    //the top level nodes are listed while a load adds some
+    std::atomic<int> failures{0};
+    std::thread reader{[&schema, &failures]() {
+        for(int j = 0; j < 20; ++j)
+        {
+            for(auto & child : schema->children())
+            {
+                if(child == nullptr || child->path().empty())
+                    ++failures;
+            }
+        }
+    }};
+    BOOST_REQUIRE(!schema->find("ietf-interfaces:interfaces").empty());
+    reader.join();
+    BOOST_REQUIRE(failures == 0);
+}
+
+BOOST_AUTO_TEST_CASE( lazy_loading_identities )
+{
+    std::string searchdir{TEST_HOME};
+    ydk::path::Repository repo{searchdir};
+    repo.set_lazy_loading(true);
+
+    std::vector<ydk::path::Capability> capabilities {
+        {"ydktest-sanity", ""},
+        {"ydktest-sanity-types", ""},
+        {"ydktest-types", ""}
+    };
+    std::unique_ptr<ydk::path::RootSchemaNode> schema{repo.create_root_schema(capabilities)};
+    BOOST_REQUIRE(schema.get() != nullptr);
+    auto leaf = schema->find("ydktest-sanity:runner/ytypes/built-in-t/identity-ref-value");
+    BOOST_REQUIRE(!leaf.empty());
+    auto & type = leaf[0]->type();
+    BOOST_REQUIRE(!type.validate("ydktest-sanity:child-identity").has_errors());
+    BOOST_REQUIRE(type.validate("ydktest-sanity-types:other").has_errors());
+
+    //the module loaded later derives from the identity the leaf refers to
+    BOOST_REQUIRE(schema->find("ydktest-sanity-types:other").empty());
+    BOOST_REQUIRE(!type.validate("ydktest-sanity-types:other").has_errors());
+    BOOST_REQUIRE(!type.validate("ydktest-sanity-types:ydktest-type").has_errors());
+}
+
 BOOST_AUTO_TEST_CASE( bits_order )
 {
     std::string searchdir{TEST_HOME};
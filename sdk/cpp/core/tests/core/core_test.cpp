@@ -24,8 +24,13 @@
 #define BOOST_TEST_MODULE CoreTest
 #include <boost/test/unit_test.hpp>
 #include <iostream>
+#include <fstream>
+#include "../../src/crud_service.hpp"
+#include "../../src/netconf_service.hpp"
 #include "../../src/path_api.hpp"
 #include "../../src/path/path_private.hpp"
+#include "../../src/netconf_stats.hpp"
+#include "../../src/task_executor.hpp"
 #include "../config.hpp"
 
 BOOST_AUTO_TEST_CASE( test_segmentalize  )
@@ -39,3 +44,88 @@ BOOST_AUTO_TEST_CASE( test_segmentalize  )
 		BOOST_REQUIRE(segments[index] == expected[index]);
 	}
 }
+
+BOOST_AUTO_TEST_CASE( test_netconf_stats  )
+{
+	ydk::NetconfStats stats{};
+	stats.record("get-config", ydk::RpcPhase::wait, std::chrono::microseconds{1});
+	BOOST_REQUIRE(stats.snapshot().empty());
+
+	stats.set_enabled(true);
+	for (int us = 1; us <= 100; us++)
+	{
+		stats.record("get-config", ydk::RpcPhase::wait, std::chrono::microseconds{us}, 10, 1000);
+	}
+	stats.record("get-config", ydk::RpcPhase::wait, std::chrono::microseconds{5000}, 10, 1000);
+
+	auto snapshot = stats.snapshot();
+	auto & wait = snapshot["get-config"][ydk::RpcPhase::wait];
+	BOOST_REQUIRE(wait.count == 101);
+	BOOST_REQUIRE(wait.request_bytes == 1010);
+	BOOST_REQUIRE(wait.reply_bytes == 101000);
+	BOOST_REQUIRE(wait.max == std::chrono::microseconds{5000});
+	BOOST_REQUIRE(wait.p50.count() >= 51 && wait.p50.count() <= 51 + 51 / 8);
+	BOOST_REQUIRE(wait.p99.count() >= 100 && wait.p99.count() <= 100 + 100 / 8);
+
+	stats.reset();
+	BOOST_REQUIRE(stats.snapshot().empty());
+
+	stats.set_enabled(false);
+	stats.record("get-config", ydk::RpcPhase::wait, std::chrono::microseconds{1});
+	BOOST_REQUIRE(stats.snapshot().empty());
+}
+
+BOOST_AUTO_TEST_CASE( test_get_rpc_name  )
+{
+	BOOST_REQUIRE(ydk::get_rpc_name("<rpc xmlns=\"urn:ietf:params:xml:ns:netconf:base:1.0\">\n  <edit-config xmlns=\"urn:ietf:params:xml:ns:netconf:base:1.0\">") == "edit-config");
+	BOOST_REQUIRE(ydk::get_rpc_name("<rpc><nc:get-config>") == "get-config");
+	BOOST_REQUIRE(ydk::get_rpc_name("<rpc><commit/></rpc>") == "commit");
+}
+
+BOOST_AUTO_TEST_CASE( test_thread_pool_executor  )
+{
+	ydk::ThreadPoolExecutor executor{1};
+
+	//exceptions of any type reach the future
+	auto failed = ydk::submit(executor, []() -> int { throw 42; });
+	BOOST_REQUIRE_THROW(failed.get(), int);
+
+	//a throwing callback does not take the worker down
+	ydk::submit(executor, []() { return 1; }, [](std::future<int> result) { throw 42; });
+	auto next = ydk::submit(executor, []() { return 2; });
+	BOOST_REQUIRE(next.wait_for(std::chrono::seconds(10)) == std::future_status::ready);
+	BOOST_REQUIRE(next.get() == 2);
+}
+
+BOOST_AUTO_TEST_CASE( test_default_executor_threads  )
+{
+	//services only start the default executor on their first asynchronous call
+	ydk::CrudService crud{};
+	ydk::NetconfService netconf{};
+	ydk::set_default_executor_threads(3);
+	BOOST_REQUIRE(ydk::get_default_executor().concurrency() == 3);
+}
+
+BOOST_AUTO_TEST_CASE( test_capabilities_fingerprint  )
+{
+	boost::filesystem::path dir = boost::filesystem::temp_directory_path() / boost::filesystem::unique_path();
+	boost::filesystem::create_directories(dir);
+	std::vector<ydk::path::Capability> capabilities{{"ydktest-sanity", "", {}, {"ydktest-sanity-deviations"}}};
+
+	{
+		std::ofstream file{(dir / "ydktest-sanity-deviations.yang").string()};
+		file << "module ydktest-sanity-deviations { deviation /a { deviate not-supported; } }";
+	}
+	std::string before = ydk::path::get_capabilities_fingerprint(capabilities, dir);
+	BOOST_REQUIRE(before == ydk::path::get_capabilities_fingerprint(capabilities, dir));
+
+	//same capabilities, different deviation content
+	{
+		std::ofstream file{(dir / "ydktest-sanity-deviations.yang").string()};
+		file << "module ydktest-sanity-deviations { deviation /b { deviate not-supported; } }";
+	}
+	BOOST_REQUIRE(before != ydk::path::get_capabilities_fingerprint(capabilities, dir));
+	BOOST_REQUIRE(ydk::path::get_capabilities_fingerprint(capabilities, dir / "missing") == ydk::path::get_capabilities_fingerprint(capabilities, dir / "other"));
+
+	boost::filesystem::remove_all(dir);
+}
@@ -22,6 +22,8 @@
 
 #include "../core/src/netconf_provider.hpp"
 #include "../core/src/crud_service.hpp"
+#include "../core/src/fleet_executor.hpp"
+#include "../core/src/task_executor.hpp"
 #include "ydk_ydktest/openconfig_bgp.hpp"
 #include "config.hpp"
 
@@ -65,6 +67,38 @@ void config_bgp(openconfig_bgp::Bgp* bgp)
 	bgp->peer_groups->peer_group.push_back(move(peer_group));
 }
 
+// forwards to the netconf provider, counting the edits whose entity reaches it attached
+// rather than encoded into the rpc input
+class AttachCheckingProvider : public ydk::path::ServiceProvider
+{
+public:
+	explicit AttachCheckingProvider(NetconfServiceProvider & provider) : provider(provider), attached_edits(0)
+	{
+	}
+
+	ydk::path::RootSchemaNode* get_root_schema() const
+	{
+		return provider.get_root_schema();
+	}
+
+	bool supports_attached_data(const std::string & name) const
+	{
+		return provider.supports_attached_data(name);
+	}
+
+	ydk::path::DataNode* invoke(ydk::path::Rpc* rpc) const
+	{
+		if(rpc->attached("entity").size() == 1 && rpc->input()->find("entity").empty())
+		{
+			++attached_edits;
+		}
+		return provider.invoke(rpc);
+	}
+
+	NetconfServiceProvider & provider;
+	mutable int attached_edits;
+};
+
 BOOST_AUTO_TEST_CASE(bgp_create_delete)
 {
 	ydk::path::Repository repo{TEST_HOME};
@@ -79,6 +113,26 @@ BOOST_AUTO_TEST_CASE(bgp_create_delete)
 	BOOST_REQUIRE(reply);
 }
 
+BOOST_AUTO_TEST_CASE(bgp_create_attached)
+{
+	ydk::path::Repository repo{TEST_HOME};
+	NetconfServiceProvider provider{repo, "127.0.0.1", "admin", "admin", 12022};
+	AttachCheckingProvider checking_provider{provider};
+	CrudService crud{};
+	auto bgp = make_unique<openconfig_bgp::Bgp>();
+	BOOST_REQUIRE(crud.delete_(checking_provider, *bgp));
+
+	config_bgp(bgp.get());
+	BOOST_REQUIRE(crud.create(checking_provider, *bgp));
+	BOOST_REQUIRE(checking_provider.attached_edits == 2);
+
+	auto bgp_filter = make_unique<openconfig_bgp::Bgp>();
+	auto bgp_read = crud.read_config(provider, *bgp_filter);
+	auto bgp_read_ptr = dynamic_cast<openconfig_bgp::Bgp*>(bgp_read.get());
+	BOOST_REQUIRE(bgp_read_ptr != nullptr);
+	BOOST_CHECK_EQUAL(bgp_read_ptr->global->config->as.get(), "65001");
+}
+
 BOOST_AUTO_TEST_CASE(bgp_read_delete)
 {
 	ydk::path::Repository repo{TEST_HOME};
@@ -168,3 +222,135 @@ BOOST_AUTO_TEST_CASE(bgp_read_create)
 	reply = crud.update(provider, *bgp_read_ptr);
 	BOOST_REQUIRE(reply);
 }
+
+BOOST_AUTO_TEST_CASE(bgp_async_create_read)
+{
+	ydk::path::Repository repo{TEST_HOME};
+	NetconfServiceProvider provider{repo, "127.0.0.1", "admin", "admin", 12022};
+	ThreadPoolExecutor executor{2};
+	CrudService crud{executor};
+	auto bgp_set = make_unique<openconfig_bgp::Bgp>();
+	BOOST_REQUIRE(crud.delete_async(provider, *bgp_set).get());
+
+	bgp_set->global->config->as = 65001;
+	BOOST_REQUIRE(crud.create_async(provider, *bgp_set).get());
+
+	auto bgp_filter = make_unique<openconfig_bgp::Bgp>();
+	std::promise<std::string> read_as;
+	auto read_as_future = read_as.get_future();
+	crud.read_config_async(provider, *bgp_filter, [&read_as](std::future<std::unique_ptr<Entity>> result) {
+		try
+		{
+			auto bgp_read = result.get();
+			auto bgp_read_ptr = dynamic_cast<openconfig_bgp::Bgp*>(bgp_read.get());
+			read_as.set_value(bgp_read_ptr == nullptr ? "" : bgp_read_ptr->global->config->as.get());
+		}
+		catch(...)
+		{
+			read_as.set_exception(std::current_exception());
+		}
+	});
+	BOOST_REQUIRE(read_as_future.wait_for(std::chrono::seconds(60)) == std::future_status::ready);
+	BOOST_CHECK_EQUAL(read_as_future.get(), "65001");
+}
+
+BOOST_AUTO_TEST_CASE(bgp_fleet_create_read)
+{
+	ydk::path::Repository repo{TEST_HOME};
+	NetconfServiceProvider provider1{repo, "127.0.0.1", "admin", "admin", 12022};
+	NetconfServiceProvider provider2{repo, "127.0.0.1", "admin", "admin", 12022};
+	std::vector<NetconfServiceProvider*> providers{&provider1, &provider2};
+	FleetExecutor fleet{};
+
+	auto bgp_set = make_unique<openconfig_bgp::Bgp>();
+	auto results = fleet.execute(providers, FleetOperation::delete_, *bgp_set);
+	BOOST_REQUIRE(results.size() == 2);
+	for(auto & result : results)
+	{
+		BOOST_REQUIRE_MESSAGE(result.ok, result.error);
+	}
+
+	bgp_set->global->config->as = 65001;
+	results = fleet.execute({&provider1}, FleetOperation::create, *bgp_set);
+	BOOST_REQUIRE_MESSAGE(results[0].ok, results[0].error);
+
+	auto bgp_filter = make_unique<openconfig_bgp::Bgp>();
+	// the callback runs on the executor's threads, only collect there and check here
+	std::vector<FleetResult> read_results;
+	fleet.execute(providers, FleetOperation::read_config, *bgp_filter, [&read_results](FleetResult result) {
+		read_results.push_back(std::move(result));
+	});
+	BOOST_REQUIRE(read_results.size() == 2);
+	for(auto & result : read_results)
+	{
+		BOOST_REQUIRE_MESSAGE(result.ok, result.error);
+		auto bgp_read = dynamic_cast<openconfig_bgp::Bgp*>(result.entity.get());
+		BOOST_REQUIRE(bgp_read != nullptr);
+		BOOST_CHECK_EQUAL(bgp_read->global->config->as.get(), "65001");
+	}
+}
+
+BOOST_AUTO_TEST_CASE(bgp_streaming_read)
+{
+	ydk::path::Repository repo{TEST_HOME};
+	NetconfServiceProvider provider{repo, "127.0.0.1", "admin", "admin", 12022};
+	provider.set_read_mode(ReadMode::streaming);
+	CrudService crud{};
+	auto bgp_set = make_unique<openconfig_bgp::Bgp>();
+	BOOST_REQUIRE(crud.delete_(provider, *bgp_set));
+
+	bgp_set->global->config->as = 65001;
+	auto neighbor = make_unique<openconfig_bgp::Bgp::Neighbors::Neighbor>();
+	neighbor->neighbor_address = "172.16.255.2";
+	neighbor->config->neighbor_address = "172.16.255.2";
+	neighbor->config->peer_as = 65002;
+	neighbor->parent = bgp_set->neighbors.get();
+	bgp_set->neighbors->neighbor.push_back(std::move(neighbor));
+	BOOST_REQUIRE(crud.create(provider, *bgp_set));
+
+	auto bgp_filter = make_unique<openconfig_bgp::Bgp>();
+	auto bgp_read = crud.read_config(provider, *bgp_filter);
+	BOOST_REQUIRE(bgp_read != nullptr);
+	auto bgp_read_ptr = dynamic_cast<openconfig_bgp::Bgp*>(bgp_read.get());
+	BOOST_REQUIRE(bgp_read_ptr != nullptr);
+	BOOST_CHECK_EQUAL(bgp_read_ptr->global->config->as.get(), "65001");
+	BOOST_REQUIRE(bgp_read_ptr->neighbors->neighbor.size() == 1);
+	BOOST_CHECK_EQUAL(bgp_read_ptr->neighbors->neighbor[0]->config->peer_as.get(), "65002");
+}
+
+BOOST_AUTO_TEST_CASE(bgp_transaction)
+{
+	ydk::path::Repository repo{TEST_HOME};
+	NetconfServiceProvider provider{repo, "127.0.0.1", "admin", "admin", 12022};
+	CrudService crud{};
+	{
+		auto transaction = provider.begin_transaction();
+		auto bgp = make_unique<openconfig_bgp::Bgp>();
+		BOOST_REQUIRE(crud.delete_(*transaction, *bgp));
+
+		config_bgp(bgp.get());
+		BOOST_REQUIRE(crud.create(*transaction, *bgp));
+
+		auto bgp_update = make_unique<openconfig_bgp::Bgp>();
+		bgp_update->global->config->as = 65210;
+		BOOST_REQUIRE(crud.update(*transaction, *bgp_update));
+
+		// the delete and the writes to the same top level container merge into one replace
+		BOOST_REQUIRE(transaction->get_edit_count() == 1);
+		// no session is held before the commit, the provider remains usable
+		auto bgp_before = make_unique<openconfig_bgp::Bgp>();
+		BOOST_REQUIRE_NO_THROW(crud.read_config(provider, *bgp_before));
+		BOOST_REQUIRE_THROW(crud.read(*transaction, *bgp_update), YCPPOperationNotSupportedError);
+		transaction->commit();
+		BOOST_REQUIRE(transaction->get_edit_count() == 0);
+		BOOST_REQUIRE_THROW(transaction->commit(), YCPPIllegalStateError);
+	}
+
+	auto bgp_filter = make_unique<openconfig_bgp::Bgp>();
+	auto bgp_read = crud.read_config(provider, *bgp_filter);
+	BOOST_REQUIRE(bgp_read != nullptr);
+	auto bgp_read_ptr = dynamic_cast<openconfig_bgp::Bgp*>(bgp_read.get());
+	BOOST_REQUIRE(bgp_read_ptr != nullptr);
+	BOOST_CHECK_EQUAL(bgp_read_ptr->global->config->as.get(), "65210");
+	BOOST_REQUIRE(bgp_read_ptr->neighbors->neighbor.size() == 1);
+}
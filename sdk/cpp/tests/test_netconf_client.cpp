@@ -17,8 +17,12 @@
 #include <boost/test/unit_test.hpp>
 #include <string.h>
 #include "../core/src/netconf_client.hpp"
+#include "../core/src/netconf_transport.hpp"
 #include "../core/src/errors.hpp"
+#include <atomic>
 #include <iostream>
+#include <thread>
+#include <vector>
 #include <sys/time.h>
 
 using namespace ydk;
@@ -118,6 +122,51 @@ BOOST_AUTO_TEST_CASE(EditgetConfig)
 	BOOST_REQUIRE(result == OK);
 }
 
+BOOST_AUTO_TEST_CASE(ReplyDataSection)
+{
+	NetconfClient client{ "admin", "admin", "127.0.0.1", 12022, 0};
+	int OK = 0;
+
+	int result = client.connect();
+	BOOST_REQUIRE(result == OK);
+
+	NetconfReply reply = client.execute(
+	 "<rpc xmlns=\"urn:ietf:params:xml:ns:netconf:base:1.0\">"
+	 "<edit-config>"
+	 "<target><candidate/></target>"
+	 "<config>"
+	 "<runner xmlns=\"http://cisco.com/ns/yang/ydktest-sanity\"><ytypes><built-in-t><number8>12</number8></built-in-t></ytypes></runner>"
+	 "</config>"
+	 "</edit-config>"
+	 "</rpc>");
+	BOOST_REQUIRE(reply.contains("<ok/>"));
+	BOOST_REQUIRE(reply.data_section() == nullptr);
+
+	reply = client.execute(
+	 "<rpc xmlns=\"urn:ietf:params:xml:ns:netconf:base:1.0\">"
+	 "<get-config>"
+	 "<source><candidate/></source>"
+	 "<filter>"
+	 "<runner xmlns=\"http://cisco.com/ns/yang/ydktest-sanity\"/>"
+	 "</filter>"
+	 "</get-config>"
+	 "</rpc>");
+	const char* data = reply.data_section();
+	BOOST_REQUIRE(data != nullptr);
+	BOOST_REQUIRE(NULL != strstr(data, "<number8>12</number8>"));
+	BOOST_REQUIRE(NULL == strstr(data, "</data>"));
+	BOOST_REQUIRE(NULL == strstr(data, "</rpc-reply>"));
+
+	NetconfReply moved{std::move(reply)};
+	BOOST_REQUIRE(moved.contains("<number8>12</number8>"));
+	BOOST_REQUIRE(reply.size() == 0);
+
+	client.execute_payload(
+	 "<rpc xmlns=\"urn:ietf:params:xml:ns:netconf:base:1.0\">"
+	 "<discard-changes/>"
+	 "</rpc>");
+}
+
 BOOST_AUTO_TEST_CASE(Validate)
 {
 	NetconfClient client{ "admin", "admin", "127.0.0.1", 12022, 0};
@@ -208,6 +257,53 @@ BOOST_AUTO_TEST_CASE(RpcError)
 	BOOST_REQUIRE(result == OK);
 }
 
+BOOST_AUTO_TEST_CASE(Pipelined)
+{
+	NetconfClient client{ "admin", "admin", "127.0.0.1", 12022, 0};
+	int OK = 0;
+
+	int result = client.connect();
+	BOOST_REQUIRE(result == OK);
+
+	string first = client.send_payload(
+	 "<rpc xmlns=\"urn:ietf:params:xml:ns:netconf:base:1.0\">"
+	 "<validate>"
+	 "<source><candidate/></source>"
+	 "</validate>"
+	 "</rpc>");
+	string second = client.send_payload(
+	 "<rpc xmlns=\"urn:ietf:params:xml:ns:netconf:base:1.0\">"
+	 "<get-config>"
+	 "<source><candidate/></source>"
+	 "<filter>"
+	 "<runner xmlns=\"http://cisco.com/ns/yang/ydktest-sanity\"/>"
+	 "</filter>"
+	 "</get-config>"
+	 "</rpc>");
+	BOOST_REQUIRE(first != second);
+
+	//collect out of order
+	string reply = client.collect_reply(second);
+	BOOST_REQUIRE(NULL != strstr(reply.c_str(), "<data"));
+	reply = client.collect_reply(first);
+	BOOST_REQUIRE(NULL != strstr(reply.c_str(), "<ok/>"));
+
+	vector<string> payloads(5,
+	 "<rpc xmlns=\"urn:ietf:params:xml:ns:netconf:base:1.0\">"
+	 "<validate>"
+	 "<source><candidate/></source>"
+	 "</validate>"
+	 "</rpc>");
+	vector<string> replies = client.execute_payloads(payloads, 2);
+	BOOST_REQUIRE(replies.size() == payloads.size());
+	for(auto & r : replies)
+	{
+		BOOST_REQUIRE(NULL != strstr(r.c_str(), "<ok/>"));
+	}
+
+	BOOST_REQUIRE(result == OK);
+}
+
 BOOST_AUTO_TEST_CASE(DeviceNotConnectedExecute)
 {
 	NetconfClient client{ "admin", "admin", "127.0.0.1", 12022, 0};
@@ -357,3 +453,75 @@ BOOST_AUTO_TEST_CASE(MultipleClients)
 
 }
 
+
+BOOST_AUTO_TEST_CASE(ParallelConnectCredentials)
+{
+	// a client with a wrong password connecting alongside must not affect the others
+	std::atomic<int> connected{0};
+	std::atomic<int> rejected{0};
+	std::vector<std::thread> threads;
+	for(int i = 0; i < 8; i++)
+	{
+		std::string password = (i == 3) ? "wrong" : "admin";
+		threads.emplace_back([password, &connected, &rejected]() {
+			NetconfClient client{ "admin", password, "127.0.0.1", 12022, 0};
+			try
+			{
+				client.connect();
+				++connected;
+			}
+			catch (YCPPError & e)
+			{
+				++rejected;
+			}
+		});
+	}
+	for(auto & thread : threads)
+	{
+		thread.join();
+	}
+	BOOST_REQUIRE(connected == 7);
+	BOOST_REQUIRE(rejected == 1);
+}
+
+BOOST_AUTO_TEST_CASE(KeepaliveReconnect)
+{
+	NetconfClient client{ "admin", "admin", "127.0.0.1", 12022, 0};
+	BOOST_REQUIRE(!client.is_alive());
+
+	client.connect();
+	BOOST_REQUIRE(client.is_alive());
+	auto capabilities = client.get_capabilities();
+
+	client.reconnect();
+	BOOST_REQUIRE(client.is_alive());
+	BOOST_REQUIRE(client.get_capabilities() == capabilities);
+
+	string reply = client.execute_payload(
+	 "<rpc xmlns=\"urn:ietf:params:xml:ns:netconf:base:1.0\">"
+	 "<get-config>"
+	 "<source><candidate/></source>"
+	 "</get-config>"
+	 "</rpc>");
+	BOOST_REQUIRE(reply.find("<data") != string::npos);
+}
+
+BOOST_AUTO_TEST_CASE(Transport)
+{
+	SshTransport ssh{"admin", "admin", "127.0.0.1", 12022};
+	NetconfClient client{ssh.clone(), 0};
+	BOOST_REQUIRE(client.connect() == 0);
+	BOOST_REQUIRE(client.get_hostname_port() == "127.0.0.1:12022");
+	BOOST_REQUIRE(client.is_alive());
+
+	NetconfClient unix_client{unique_ptr<NetconfTransport>{new UnixSocketTransport{"admin", "/nonexistent/netconf.sock"}}, 0};
+	try
+	{
+		unix_client.connect();
+		BOOST_FAIL("connected to a socket that does not exist");
+	}
+	catch (YCPPClientError & e)
+	{
+		BOOST_REQUIRE(e.err_msg == "Could not connect to /nonexistent/netconf.sock");
+	}
+}
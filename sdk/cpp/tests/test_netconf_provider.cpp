@@ -17,8 +17,11 @@
 #include <boost/test/unit_test.hpp>
 #include <string.h>
 #include "../core/src/netconf_provider.hpp"
+#include "../core/src/netconf_transport.hpp"
 #include "../core/src/errors.hpp"
+#include <future>
 #include <iostream>
+#include <vector>
 #include "config.hpp"
 
 using namespace ydk;
@@ -43,3 +46,219 @@ BOOST_AUTO_TEST_CASE(CreateNoRepo)
 	auto root_schema = provider.get_root_schema();
 	BOOST_REQUIRE(root_schema != nullptr);
 }
+
+BOOST_AUTO_TEST_CASE(CreateWithSessionPool)
+{
+	NetconfSessionPoolOptions options{};
+	options.min_size = 2;
+	options.max_size = 4;
+	NetconfServiceProvider provider{"127.0.0.1", "admin", "admin", 12022, options};
+
+	auto root_schema = provider.get_root_schema();
+	BOOST_REQUIRE(root_schema != nullptr);
+
+	std::string payload = R"(<rpc xmlns="urn:ietf:params:xml:ns:netconf:base:1.0">
+  <validate>
+    <source>
+      <candidate/>
+    </source>
+  </validate>
+</rpc>)";
+
+	std::vector<std::future<std::string>> replies;
+	for(int i = 0; i < 8; ++i)
+	{
+		replies.push_back(std::async(std::launch::async, [&provider, &payload]() {
+			return provider.execute_payload(payload);
+		}));
+	}
+	for(auto & reply : replies)
+	{
+		BOOST_REQUIRE(reply.get().find("<ok/>") != std::string::npos);
+	}
+}
+
+BOOST_AUTO_TEST_CASE(SessionPoolReplacement)
+{
+	NetconfSessionPoolOptions options{};
+	options.min_size = 1;
+	options.max_size = 2;
+	options.idle_timeout = std::chrono::seconds{0};
+	options.keepalive_interval = std::chrono::seconds{0};
+	NetconfServiceProvider provider{"127.0.0.1", "admin", "admin", 12022, options};
+	auto root_schema = provider.get_root_schema();
+
+	std::string payload = R"(<rpc xmlns="urn:ietf:params:xml:ns:netconf:base:1.0">
+  <validate>
+    <source>
+      <candidate/>
+    </source>
+  </validate>
+</rpc>)";
+
+	// the second session is closed by keepalive() and opened again by the next round
+	for(int round = 0; round < 2; ++round)
+	{
+		std::vector<std::future<std::string>> replies;
+		for(int i = 0; i < 4; ++i)
+		{
+			replies.push_back(std::async(std::launch::async, [&provider, &payload]() {
+				return provider.execute_payload(payload);
+			}));
+		}
+		for(auto & reply : replies)
+		{
+			BOOST_REQUIRE(reply.get().find("<ok/>") != std::string::npos);
+		}
+		provider.keepalive();
+		BOOST_REQUIRE(provider.get_root_schema() == root_schema);
+	}
+	BOOST_REQUIRE(provider.execute_payload(payload).find("<ok/>") != std::string::npos);
+}
+
+BOOST_AUTO_TEST_CASE(CreateWithReactor)
+{
+	NetconfReactorOptions options{};
+	options.num_threads = 2;
+	options.max_in_flight = 4;
+	NetconfReactor reactor{options};
+
+	ydk::path::Repository repo{};
+	NetconfServiceProvider provider1{reactor, repo, "127.0.0.1", "admin", "admin", 12022};
+	NetconfServiceProvider provider2{reactor, repo, "127.0.0.1", "admin", "admin", 12022};
+	BOOST_REQUIRE(provider1.get_root_schema() != nullptr);
+	BOOST_REQUIRE(provider2.get_root_schema() != nullptr);
+	BOOST_REQUIRE(reactor.size() == 2);
+
+	std::string payload = R"(<rpc xmlns="urn:ietf:params:xml:ns:netconf:base:1.0">
+  <validate>
+    <source>
+      <candidate/>
+    </source>
+  </validate>
+</rpc>)";
+
+	BOOST_REQUIRE(provider1.execute_payload(payload).find("<ok/>") != std::string::npos);
+
+	auto id = reactor.connect("admin", "admin", "127.0.0.1", 12022);
+	std::vector<std::future<std::string>> replies;
+	for(int i = 0; i < 10; ++i)
+	{
+		replies.push_back(reactor.submit(id, payload));
+	}
+	for(auto & reply : replies)
+	{
+		BOOST_REQUIRE(reply.get().find("<ok/>") != std::string::npos);
+	}
+	reactor.disconnect(id);
+	BOOST_REQUIRE_THROW(reactor.submit(id, payload), YCPPInvalidArgumentError);
+}
+
+BOOST_AUTO_TEST_CASE(Stats)
+{
+	ydk::path::Repository repo{};
+	NetconfServiceProvider provider{repo, "127.0.0.1", "admin", "admin", 12022};
+	provider.get_stats().set_enabled(true);
+
+	std::string payload = R"(<rpc xmlns="urn:ietf:params:xml:ns:netconf:base:1.0">
+  <validate>
+    <source>
+      <candidate/>
+    </source>
+  </validate>
+</rpc>)";
+	for(int i = 0; i < 3; i++)
+	{
+		provider.execute_payload(payload);
+	}
+
+	auto snapshot = provider.get_stats().snapshot();
+	BOOST_REQUIRE(snapshot.find("validate") != snapshot.end());
+	auto & validate = snapshot["validate"];
+	for(auto phase : {RpcPhase::build, RpcPhase::send, RpcPhase::wait, RpcPhase::dump})
+	{
+		BOOST_REQUIRE(validate[phase].count == 3);
+		BOOST_REQUIRE(validate[phase].request_bytes == 3 * payload.size());
+		BOOST_REQUIRE(validate[phase].p50 <= validate[phase].p99);
+		BOOST_REQUIRE(validate[phase].p99 <= validate[phase].max);
+	}
+	BOOST_REQUIRE(validate[RpcPhase::wait].reply_bytes > 0);
+
+	provider.get_stats().reset();
+	BOOST_REQUIRE(provider.get_stats().snapshot().empty());
+}
+
+BOOST_AUTO_TEST_CASE(StartupPhases)
+{
+	ydk::path::Repository repo{};
+	NetconfServiceProvider provider{repo, "127.0.0.1", "admin", "admin", 12022};
+
+	auto totals = provider.get_startup_profile().get_totals();
+	for(auto phase : {"connect", "capabilities", "get-core-capabilities", "create-root-schema", "build-schema-tree"})
+	{
+		BOOST_REQUIRE(totals.find(phase) != totals.end());
+	}
+	BOOST_REQUIRE(totals["create-root-schema"] <= provider.get_startup_profile().get_elapsed());
+	BOOST_REQUIRE(provider.get_startup_profile().to_json().find("\"name\":\"connect\"") != std::string::npos);
+
+	// the profile is only recorded while the provider is being constructed
+	auto phases = provider.get_startup_profile().get_phases().size();
+	provider.execute_payload(R"(<rpc xmlns="urn:ietf:params:xml:ns:netconf:base:1.0"><validate><source><candidate/></source></validate></rpc>)");
+	BOOST_REQUIRE(provider.get_startup_profile().get_phases().size() == phases);
+}
+
+BOOST_AUTO_TEST_CASE(Subscribe)
+{
+	ydk::path::Repository repo{};
+	NetconfServiceProvider provider{repo, "127.0.0.1", "admin", "admin", 12022};
+
+	auto subscription = provider.subscribe();
+	BOOST_REQUIRE(subscription->is_active());
+
+	// a change to the running datastore raises netconf-config-change on the NETCONF stream
+	for(std::string operation : {"merge", "delete"})
+	{
+		provider.execute_payload(R"(<rpc xmlns="urn:ietf:params:xml:ns:netconf:base:1.0">
+  <edit-config>
+    <target><running/></target>
+    <config>
+      <runner xmlns="http://cisco.com/ns/yang/ydktest-sanity" xmlns:nc="urn:ietf:params:xml:ns:netconf:base:1.0" nc:operation=")" + operation + R"("><ytypes><built-in-t><number8>12</number8></built-in-t></ytypes></runner>
+    </config>
+  </edit-config>
+</rpc>)");
+	}
+
+	NetconfNotification notification{};
+	BOOST_REQUIRE(subscription->pop(notification, std::chrono::seconds{10}));
+	BOOST_REQUIRE(notification.payload.find("netconf-config-change") != std::string::npos);
+	BOOST_REQUIRE(subscription->get_dropped() == 0);
+
+	subscription->close();
+	BOOST_REQUIRE(!subscription->is_active());
+}
+
+BOOST_AUTO_TEST_CASE(SharedRootSchema)
+{
+	ydk::path::Repository repo{TEST_HOME};
+	NetconfServiceProvider provider{repo, "127.0.0.1", "admin", "admin", 12022};
+	ydk::path::Repository other_repo{TEST_HOME};
+	NetconfServiceProvider other_provider{other_repo, "127.0.0.1", "admin", "admin", 12022};
+
+	BOOST_REQUIRE(provider.get_root_schema() == other_provider.get_root_schema());
+}
+
+BOOST_AUTO_TEST_CASE(ConfirmedTransactionWithoutCandidate)
+{
+	// a device announcing the base capability only, which reads its input without answering
+	StdioTransport device{"admin", {"sh", "-c", "printf '%s' '"
+		"<hello xmlns=\"urn:ietf:params:xml:ns:netconf:base:1.0\"><capabilities>"
+		"<capability>urn:ietf:params:netconf:base:1.0</capability>"
+		"</capabilities><session-id>1</session-id></hello>]]>]]>'; cat > /dev/null"}};
+	ydk::path::Repository repo{TEST_HOME};
+	NetconfServiceProvider provider{repo, device};
+
+	// the edits would go straight to running, with no confirm window and nothing to roll back
+	NetconfTransactionOptions options{};
+	options.confirmed = true;
+	BOOST_REQUIRE_THROW(provider.begin_transaction(options), YCPPOperationNotSupportedError);
+}